@@ -0,0 +1,135 @@
+#!/usr/bin/env bash
+# Load test of a local dedicated server with headless bot clients.
+#
+# For each player count a server is started with -MobaLoadTest=<count>. It waits for that many
+# bots, captures a CSV profile for SECONDS and writes its net accounting, then quits.
+# The server CSVs and accounting files are collected into one report.
+#
+# Usage: Scripts/LoadTest.sh [counts...]            default: 10 20 50
+#
+# Environment:
+#   UE4_EDITOR    path to UE4Editor (Linux: Engine/Binaries/Linux/UE4Editor), used for server and clients
+#   SERVER_BIN    packaged server binary, instead of UE4_EDITOR -server
+#   CLIENT_BIN    packaged client binary, instead of UE4_EDITOR -game
+#   CAPTURE_SECONDS  capture length per run, default 120
+#   BOT_SCRIPT    bot script for every client (see MobaLoadTest.h), random play otherwise
+#   PORT          server port, default 7777
+#   SAVED_DIR     Saved directory the server writes to, default the project's
+#   OUT           report directory, default Saved/LoadTest/<date>
+
+set -euo pipefail
+
+PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+UPROJECT="$PROJECT_DIR/BattleMoba.uproject"
+if [[ $# -gt 0 ]]; then
+	COUNTS=("$@")
+else
+	COUNTS=(10 20 50)
+fi
+SECONDS_PER_RUN="${CAPTURE_SECONDS:-120}"
+PORT="${PORT:-7777}"
+SAVED_DIR="${SAVED_DIR:-$PROJECT_DIR/Saved}"
+OUT="${OUT:-$SAVED_DIR/LoadTest/$(date +%Y%m%d-%H%M%S)}"
+CSV_DIR="$SAVED_DIR/Profiling/CSV"
+LOG_DIR="$SAVED_DIR/Logs"
+
+if [[ -n "${SERVER_BIN:-}" ]]; then
+	SERVER=("$SERVER_BIN")
+elif [[ -n "${UE4_EDITOR:-}" ]]; then
+	SERVER=("$UE4_EDITOR" "$UPROJECT" -server)
+else
+	echo "Set UE4_EDITOR or SERVER_BIN" >&2
+	exit 1
+fi
+
+if [[ -n "${CLIENT_BIN:-}" ]]; then
+	CLIENT=("$CLIENT_BIN")
+elif [[ -n "${UE4_EDITOR:-}" ]]; then
+	CLIENT=("$UE4_EDITOR" "$UPROJECT" -game)
+else
+	echo "Set UE4_EDITOR or CLIENT_BIN" >&2
+	exit 1
+fi
+
+BOT_ARGS=()
+if [[ -n "${BOT_SCRIPT:-}" ]]; then
+	BOT_ARGS+=("-MobaBotScript=$BOT_SCRIPT")
+fi
+
+mkdir -p "$OUT" "$CSV_DIR"
+CLIENT_PIDS=()
+
+stop_clients() {
+	for pid in "${CLIENT_PIDS[@]:-}"; do
+		kill "$pid" 2>/dev/null || true
+	done
+	wait 2>/dev/null || true
+	CLIENT_PIDS=()
+}
+trap stop_clients EXIT
+
+for count in "${COUNTS[@]}"; do
+	echo "== $count players, $SECONDS_PER_RUN s"
+	run_dir="$OUT/$count"
+	mkdir -p "$run_dir"
+	marker="$run_dir/.start"
+	touch "$marker"
+
+	"${SERVER[@]}" -log -nullrhi -nosound -unattended -Port="$PORT" \
+		-MobaLoadTest="$count" -MobaLoadTestSeconds="$SECONDS_PER_RUN" \
+		-abslog="$run_dir/server.log" >/dev/null 2>&1 &
+	server_pid=$!
+
+	# give the server time to load the map before the clients knock
+	sleep 10
+
+	for ((i = 0; i < count; i++)); do
+		"${CLIENT[@]}" "127.0.0.1:$PORT" -nullrhi -nosound -nosplash -unattended -windowed \
+			-MobaBot -MobaBotSeed="$i" ${BOT_ARGS[@]+"${BOT_ARGS[@]}"} \
+			-abslog="$run_dir/client$i.log" >/dev/null 2>&1 &
+		CLIENT_PIDS+=($!)
+		sleep 0.2
+	done
+
+	wait "$server_pid" || echo "server exited with $?"
+	stop_clients
+
+	find "$CSV_DIR" -name '*.csv' -newer "$marker" -exec cp {} "$run_dir/" \;
+	if [[ -f "$LOG_DIR/NetAccounting-$count.csv" ]]; then
+		mv "$LOG_DIR/NetAccounting-$count.csv" "$run_dir/NetAccounting.csv"
+	fi
+	rm -f "$marker"
+done
+
+# One row per run and stat: the mean and worst frame of the server CSV, then the bytes accounted over the whole session
+report="$OUT/report.csv"
+echo "Players,Stat,Mean,Max" > "$report"
+for count in "${COUNTS[@]}"; do
+	run_dir="$OUT/$count"
+	for csv in "$run_dir"/*.csv; do
+		[[ -e "$csv" && "$(basename "$csv")" != "NetAccounting.csv" ]] || continue
+		awk -F, -v players="$count" '
+			NR == 1 {
+				for (i = 1; i <= NF; i++)
+					if ($i == "FrameTime" || $i == "GameThreadTime" || $i ~ /^BattleMoba\//) keep[i] = $i
+				next
+			}
+			# metadata and the repeated header at the end are not frames
+			$1 !~ /^[0-9.]+$/ { next }
+			{
+				frames++
+				for (i in keep) { sum[i] += $i; if ($i > max[i]) max[i] = $i }
+			}
+			END {
+				for (i in keep) printf "%s,%s,%.3f,%.3f\n", players, keep[i], frames ? sum[i] / frames : 0, max[i]
+			}' "$csv" | sort -t, -k2,2 >> "$report"
+	done
+	if [[ -f "$run_dir/NetAccounting.csv" ]]; then
+		# Bytes is the second to last column, counted from the end since connection names are quoted
+		awk -F, -v players="$count" '
+			NR > 1 { bytes += $(NF - 1) }
+			END { printf "%s,NetAccounting/TotalBytes,%.0f,%.0f\n", players, bytes, bytes }' "$run_dir/NetAccounting.csv" >> "$report"
+	fi
+done
+
+echo "Report: $report"
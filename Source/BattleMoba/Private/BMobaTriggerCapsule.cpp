@@ -13,6 +13,9 @@
 
 /////////////////////////////////
 #include "BattleMobaCharacter.h"
+#include "MobaWorldRegistry.h"
+#include "MobaWidgetManager.h"
+#include "BattleMoba.h"
 
 
 void ABMobaTriggerCapsule::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -45,6 +48,8 @@ ABMobaTriggerCapsule::ABMobaTriggerCapsule()
 	W_Val->SetWidgetSpace(EWidgetSpace::Screen);
 	W_Val->SetDrawAtDesiredSize(true);
 	W_Val->SetGenerateOverlapEvents(false);
+
+	ValueWidget = FMobaWidgetBinding(TEXT("ValText"), TEXT("PBar"));
 }
 
 bool ABMobaTriggerCapsule::ChangeUIMulticast_Validate(ABattleMobaCharacter * actor)
@@ -68,26 +73,48 @@ void ABMobaTriggerCapsule::ChangeUI_Implementation(ABattleMobaCharacter * actor)
 void ABMobaTriggerCapsule::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Register(this, TeamName);
+	}
+
+	if (UMobaWidgetManager* WidgetManager = GetWorld()->GetSubsystem<UMobaWidgetManager>())
+	{
+		WidgetManager->RegisterWidget(W_Val);
+	}
 }
 
-void ABMobaTriggerCapsule::OnRep_Val()
+void ABMobaTriggerCapsule::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	UUserWidget* HPWidget = Cast<UUserWidget>(W_Val->GetUserWidgetObject());
-	if (HPWidget)
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
 	{
-		const FName hptext = FName(TEXT("ValText"));
-		UTextBlock* HealthText = (UTextBlock*)(HPWidget->WidgetTree->FindWidget(hptext));
+		Registry->Unregister(this);
+	}
 
-		/*const FName hpbar = FName(TEXT("HPBar"));
-		UProgressBar* HealthBar = (UProgressBar*)(HPWidget->WidgetTree->FindWidget(hpbar));*/
+	if (UMobaWidgetManager* WidgetManager = GetWorld()->GetSubsystem<UMobaWidgetManager>())
+	{
+		WidgetManager->UnregisterWidget(W_Val);
+	}
 
-		if (HealthText)
-		{
-			FString TheFloatStr = FString::SanitizeFloat(this->val);
+	Super::EndPlay(EndPlayReason);
+}
 
-			HealthText->SetText(FText::FromString(TheFloatStr));
-			//HealthBar->SetPercent(FMath::Clamp(this->Health / 100.0f, 0.0f, 1.0f));
-		}
+void ABMobaTriggerCapsule::OnRep_Team()
+{
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->SetTeam(this, TeamName);
+	}
+}
+
+void ABMobaTriggerCapsule::OnRep_Val()
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetUpdate);
+
+	if (ValueWidget.Bind(W_Val))
+	{
+		ValueWidget.SetValue(this->val);
 	}
 }
 
@@ -124,6 +151,7 @@ void ABMobaTriggerCapsule::OnOverlapBegin(AActor* OverlappedActor, AActor* Other
 			//	}*/
 			//}
 			TeamName = pc->TeamName;
+			OnRep_Team();
 			pc->SafeZone(this);
 		}
 	}
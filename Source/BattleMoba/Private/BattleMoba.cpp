@@ -4,4 +4,8 @@
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, BattleMoba, "BattleMoba" );
- 
\ No newline at end of file
+
+CSV_DEFINE_CATEGORY_MODULE(BATTLEMOBA_API, BattleMoba, true);
+
+DEFINE_STAT(STAT_MobaWidgetUpdate);
+DEFINE_STAT(STAT_MobaWidgetUpdateCalls);
@@ -11,10 +11,22 @@
 #include "Components/WidgetComponent.h"
 #include "TimerManager.h"
 #include "Styling/SlateColor.h"
+#include "Kismet/GameplayStatics.h"
 
 #include "BattleMobaCharacter.h"
 #include "BattleMobaPlayerState.h"
 #include "BattleMobaGameState.h"
+#include "MobaWorldRegistry.h"
+#include "MobaWidgetManager.h"
+#include "MobaNetAccounting.h"
+#include "BattleMoba.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaFlagOccupancy, "Flag Occupancy");
+MOBA_DECLARE_HOT_PATH(STAT_MobaFlagTick, "Flag Tick");
+MOBA_DECLARE_HOT_PATH(STAT_MobaGoldTick, "Gold Tick");
+
+//Fastest capture step, a crowded flag would otherwise reach a zero rate and SetTimer would clear FlagTimer
+static const float MinCaptureStepSeconds = 0.05f;
 
 void ABattleMobaCTF::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
@@ -28,6 +40,19 @@ void ABattleMobaCTF::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLi
 	DOREPLIFETIME(ABattleMobaCTF, isCompleted);
 	DOREPLIFETIME(ABattleMobaCTF, GoldTimer);
 	DOREPLIFETIME(ABattleMobaCTF, ActivePlayer);
+	DOREPLIFETIME(ABattleMobaCTF, Capture);
+}
+
+bool ABattleMobaCTF::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	UMobaNetAccounting::RecordRpcFor(this, Function, Parameters);
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void ABattleMobaCTF::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+	UMobaNetAccounting::RecordPropertiesFor(this);
 }
 
 // Sets default values
@@ -63,8 +88,11 @@ ABattleMobaCTF::ABattleMobaCTF()
 	W_ValControl->SetDrawAtDesiredSize(true);
 	W_ValControl->SetGenerateOverlapEvents(false);
 
-	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = false;
+	ValueWidget = FMobaWidgetBinding(TEXT("ValText"), TEXT("PBar"));
+
+	// Ticks only while the capture widget is extrapolating
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 }
 
@@ -76,168 +104,246 @@ void ABattleMobaCTF::BeginPlay()
 	//		Run TimerFunction every ControllingSpeed after 1 second the game has started
 	//this->GetWorldTimerManager().SetTimer(FlagTimer, this, &ABattleMobaCTF::TimerFunction, ControllingSpeed, true, 1.0f);
 
-	//		Find all actors of class ONCE for GoldTimerFunction
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABattleMobaCharacter::StaticClass(), GiveGoldActors);
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Register(this, ControllerTeam);
+	}
+
+	if (UMobaWidgetManager* WidgetManager = GetWorld()->GetSubsystem<UMobaWidgetManager>())
+	{
+		WidgetManager->RegisterWidget(W_ValControl);
+	}
 
 	//		Run GoldTimerFunction every 1 second after 20 seconds the game has started
 	this->GetWorldTimerManager().SetTimer(GoldTimer, this, &ABattleMobaCTF::GoldTimerFunction, 1.0f, true, 20.0f);
 
-	this->GetWorldTimerManager().SetTimer(FlagTimer, this, &ABattleMobaCTF::TimerFunction, ControllingSpeed, false, 0.0f);
+	//		FlagTimer is armed by RecomputeCaptureRate once a team occupies the flag
+}
+
+void ABattleMobaCTF::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Unregister(this);
+	}
+
+	if (UMobaWidgetManager* WidgetManager = GetWorld()->GetSubsystem<UMobaWidgetManager>())
+	{
+		WidgetManager->UnregisterWidget(W_ValControl);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ABattleMobaCTF::OnRep_ControllerTeam()
+{
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->SetTeam(this, ControllerTeam);
+	}
 }
 
 void ABattleMobaCTF::OnOverlapBegin(AActor* OverlappedActor, AActor* OtherActor)
 {
-	if (OtherActor && (OtherActor != this))
+	if (OtherActor && (OtherActor != this) && HasAuthority())
 	{
 		ABattleMobaCharacter* pb = Cast<ABattleMobaCharacter>(OtherActor);
-		if (pb)
+		if (pb && !this->OverlappedPlayer.Contains(pb))
 		{
-			//	set CTFentering to true to add integer of a team in the sphere
-			pb->CTFentering = true;
-
-			//this->GetWorldTimerManager().SetTimer(FlagTimer, this, &ABattleMobaCTF::TimerFunction, ControllingSpeed, false, 0.0f);
-			
-			
-
-			
-			/*if (pb->TeamName == "Radiant")
-			{
-				float csRadiant = ControllingSpeed - (SpeedMultiplier * float(RadiantControl));
-				this->GetWorldTimerManager().SetTimer(FlagTimer, this, &ABattleMobaCTF::TimerFunction, csRadiant, true, 0.0f);
-				GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Capture Speed for Radiant: %f"), csRadiant));
-			}
-			
-			else if (pb->TeamName == "Dire")
-			{
-				float csDire = ControllingSpeed - (SpeedMultiplier * float(DireControl));
-				this->GetWorldTimerManager().SetTimer(FlagTimer, this, &ABattleMobaCTF::TimerFunction, csDire, true, 0.0f);
-				GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Capture Speed for Dire: %f"), csDire));
-			}*/
-			
+			//	add the player to its team count in the sphere
+			this->OverlappedPlayer.Add(pb);
+			UpdateOccupancy(pb, 1);
 		}
 	}
 }
 
 void ABattleMobaCTF::OnOverlapEnd(AActor * OverlappedActor, AActor * OtherActor)
 {
-	if (OtherActor && (OtherActor != this))
+	if (OtherActor && (OtherActor != this) && HasAuthority())
 	{
 		ABattleMobaCharacter* pe = Cast<ABattleMobaCharacter>(OtherActor);
-		if (pe)
+		if (pe && this->OverlappedPlayer.RemoveSingleSwap(pe, false) > 0)
 		{
-			//		set CTFentering to true to deduct integer of a team in the sphere
-			pe->CTFentering = false;
+			//		deduct the player from its team count in the sphere
+			UpdateOccupancy(pe, -1);
 		}
 	}
 }
 
-void ABattleMobaCTF::OnRep_Val()
+void ABattleMobaCTF::UpdateOccupancy(ABattleMobaCharacter* Player, int32 Delta)
+{
+	switch (TMobaTeamList<ABattleMobaCharacter>::TeamIndex(Player->TeamName))
+	{
+	case 0:
+		this->RadiantControl = FMath::Max(this->RadiantControl + Delta, 0);
+		break;
+
+	case 1:
+		this->DireControl = FMath::Max(this->DireControl + Delta, 0);
+		break;
+
+	default:
+		return;
+	}
+
+	RecomputeCaptureRate();
+}
+
+void ABattleMobaCTF::RecomputeCaptureRate()
 {
-	UUserWidget* HPWidget = Cast<UUserWidget>(W_ValControl->GetUserWidgetObject());
-	if (HPWidget)
+	MOBA_SCOPE_CYCLE(STAT_MobaFlagOccupancy);
+
+	FName NewTeam = "";
+	int32 Count = 0;
+
+	if (this->RadiantControl > 0 && this->DireControl == 0)
+	{
+		NewTeam = "Radiant";
+		Count = this->RadiantControl;
+	}
+
+	else if (this->DireControl > 0 && this->RadiantControl == 0)
+	{
+		NewTeam = "Dire";
+		Count = this->DireControl;
+	}
+
+	const float NewSpeed = FMath::Max(this->ConstantSpeed - (this->SpeedMultiplier * float(Count)), MinCaptureStepSeconds);
+	if (NewTeam == this->CaptureTeam && FMath::IsNearlyEqual(NewSpeed, this->ControllingSpeed) && (NewTeam.IsNone() || this->GetWorldTimerManager().IsTimerActive(FlagTimer)))
 	{
-		const FName hptext = FName(TEXT("ValText"));
-		UTextBlock* HealthText = (UTextBlock*)(HPWidget->WidgetTree->FindWidget(hptext));
+		return;
+	}
 
-		const FName hpbar = FName(TEXT("PBar"));
-		UProgressBar* PBar = (UProgressBar*)(HPWidget->WidgetTree->FindWidget(hpbar));
+	this->CaptureTeam = NewTeam;
+	this->ControllingSpeed = NewSpeed;
 
-		if (HealthText)
+	this->Capture.Direction = this->CaptureTeam == "Radiant" ? 1 : (this->CaptureTeam == "Dire" ? -1 : 0);
+	this->Capture.StepMs = uint16(FMath::Clamp(FMath::RoundToInt(this->ControllingSpeed * 1000.0f), 0, int32(MAX_uint16)));
+	OnRep_Capture();
+
+	if (this->CaptureTeam.IsNone())
+	{
+		//		empty or contested, the progress holds until one team is alone in the sphere
+		this->GetWorldTimerManager().ClearTimer(FlagTimer);
+		return;
+	}
+
+	//		the player shown as owner of the progress on the widget
+	for (AActor* Actor : this->OverlappedPlayer)
+	{
+		ABattleMobaCharacter* Player = Cast<ABattleMobaCharacter>(Actor);
+		if (Player && Player->TeamName == this->CaptureTeam)
 		{
-			if (this->valDire <= 0 && this->valRadiant > 0)
-			{
-				FString TheFloatStr = FString::SanitizeFloat(this->valRadiant);
-				HealthText->SetText(FText::FromString(TheFloatStr));
-				PBar->SetPercent(FMath::Clamp(this->valRadiant / 100.0f, 0.0f, 1.0f));
-			}
+			this->ActivePlayer = Player;
+			break;
+		}
+	}
 
-			else if (this->valRadiant <= 0 && this->valDire > 0)
-			{
-				FString TheFloatStr = FString::SanitizeFloat(this->valDire);
-				HealthText->SetText(FText::FromString(TheFloatStr));
-				PBar->SetPercent(FMath::Clamp(this->valDire / 100.0f, 0.0f, 1.0f));
-			}
-			
-			else
-			{
-				FString TheFloatStr = FString::SanitizeFloat(0.0f);
-				HealthText->SetText(FText::FromString(TheFloatStr));
-				PBar->SetPercent(FMath::Clamp(0.0f / 100.0f, 0.0f, 1.0f));
-			}
+	//		keep the time already waited for the current step so a rate change does not restart it
+	const float Elapsed = this->GetWorldTimerManager().GetTimerElapsed(FlagTimer);
+	const float FirstDelay = FMath::Max(this->ControllingSpeed - FMath::Max(Elapsed, 0.0f), KINDA_SMALL_NUMBER);
+	this->GetWorldTimerManager().SetTimer(FlagTimer, this, &ABattleMobaCTF::TimerFunction, this->ControllingSpeed, true, FirstDelay);
+}
+
+void ABattleMobaCTF::OnRep_Capture()
+{
+	this->CaptureReceivedAt = GetWorld()->GetTimeSeconds();
+
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
 
-			
-			//HealthBar->SetPercent(FMath::Clamp(this->Health / 100.0f, 0.0f, 1.0f));
+	if (this->isCompleted == false)
+	{
+		ABattleMobaGameState* thisGS = Cast<ABattleMobaGameState>(UGameplayStatics::GetGameState(this));
+		if (thisGS)
+		{
+			thisGS->SetTowerWidgetColors(this);
 		}
 	}
+
+	SetActorTickEnabled(this->Capture.IsMoving());
+	RefreshCaptureWidget();
 }
 
-void ABattleMobaCTF::TimerFunction()
+void ABattleMobaCTF::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	RefreshCaptureWidget();
+}
+
+void ABattleMobaCTF::RefreshCaptureWidget()
 {
-	//check overlapping actor in CTF sphere for every controlling speed
-	this->GetOverlappingActors(this->OverlappedPlayer, ABattleMobaCharacter::StaticClass());
-	int arrLength = this->OverlappedPlayer.Num();
+	const float Progress = this->Capture.Extrapolate(GetWorld()->GetTimeSeconds() - this->CaptureReceivedAt);
+	this->valRadiant = FMath::Max(Progress, 0.0f);
+	this->valDire = FMath::Max(-Progress, 0.0f);
 
-	this->RadiantControl = 0;
-	this->DireControl = 0;
+	OnRep_Val();
+}
 
-	for (uint8 i = 0; i < arrLength; ++i)
+void ABattleMobaCTF::OnRep_Val()
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetUpdate);
+
+	if (ValueWidget.Bind(W_ValControl))
 	{
-		ActivePlayer = Cast<ABattleMobaCharacter>(this->OverlappedPlayer[i]);
+		const float Shown = FMath::Max(this->valRadiant, this->valDire);
+		ValueWidget.SetValue(Shown);
+		ValueWidget.SetPercent(Shown / 100.0f);
+	}
+}
 
-		if (ActivePlayer)
-		{
-			if (ActivePlayer->CTFentering == true)
-			{
-				if (ActivePlayer->TeamName == "Radiant" && this->RadiantControl >= 0)
-				{
-					this->RadiantControl = this->RadiantControl + 1;
-				}
+void ABattleMobaCTF::TimerFunction()
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaFlagTick);
 
-				else if (ActivePlayer->TeamName == "Dire" && this->DireControl >= 0)
-				{
-					this->DireControl = this->DireControl + 1;
-				}
-				ActivePlayer->ControlFlagMode(this);
-			}
+	if (this->Capture.Direction == 0)
+	{
+		return;
+	}
 
-			else if (ActivePlayer->CTFentering == false)
-			{
-				if (ActivePlayer->TeamName == "Radiant" && this->RadiantControl >= 1)
-				{
-					this->RadiantControl = this->RadiantControl - 1;
-				}
+	//		the opposing team's progress drains first, then the capturing team's fills up to MaxProgress
+	const int32 MaxProgress = FMobaCaptureProgress::MaxProgress;
+	const int32 Progress = FMath::Clamp(int32(this->Capture.Progress) + int32(this->Capture.Direction), -MaxProgress, MaxProgress);
+	this->Capture.Progress = int8(Progress);
 
-				else if (ActivePlayer->TeamName == "Dire" && this->DireControl >= 1)
-				{
-					this->DireControl = this->DireControl - 1;
-				}
-				ActivePlayer->ControlFlagMode(this);
-			}
+	if (FMath::Abs(Progress) == MaxProgress)
+	{
+		if (this->ControllerTeam != this->CaptureTeam)
+		{
+			this->ControllerTeam = this->CaptureTeam;
+			OnRep_ControllerTeam();
 		}
+		this->isCompleted = true;
+
+		//		nothing left to advance until the occupancy changes
+		this->GetWorldTimerManager().ClearTimer(FlagTimer);
 	}
 
-	this->GetWorldTimerManager().SetTimer(FlagTimer, this, &ABattleMobaCTF::TimerFunction, ControllingSpeed, false, ControllingSpeed);
-	
+	else
+	{
+		this->isCompleted = false;
+	}
+
+	OnRep_Capture();
 }
 
 void ABattleMobaCTF::GoldTimerFunction()
 {
-	if (isCompleted)
-	{
-		/*if (this->GetWorldTimerManager().IsTimerActive(FlagTimer))
-		{
-			this->GetWorldTimerManager().ClearTimer(FlagTimer);
-		}*/
-		int arrLength = this->GiveGoldActors.Num();
+	MOBA_SCOPE_CYCLE(STAT_MobaGoldTick);
 
+	UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this);
+	if (isCompleted && Registry)
+	{
 		//		for every player of the controller team will gain chi orbs for every second when the Control Flag progress reaches 100
-		for (uint8 i = 0; i < arrLength; ++i)
+		for (ABattleMobaCharacter* player : Registry->GetTeam<ABattleMobaCharacter>(ControllerTeam))
 		{
-			ABattleMobaCharacter* player = Cast<ABattleMobaCharacter>(GiveGoldActors[i]);
 			if (player != nullptr && player->IsActorBeingDestroyed() == false)
 			{
 				ABattleMobaPlayerState* ps = Cast<ABattleMobaPlayerState>(player->GetPlayerState());
-				if (ps->TeamName == ControllerTeam)
+				if (ps != nullptr)
 				{
 					if (this->PointName == "BaseFlag")
 					{
@@ -253,8 +359,6 @@ void ABattleMobaCTF::GoldTimerFunction()
 					{
 						ps->ChiOrbs = ps->ChiOrbs + 10;
 					}
-
-					//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("PointName %s"), ((*PointName.ToString()))));
 				}
 			}
 		}
@@ -36,6 +36,42 @@
 #include "BattleMobaGameMode.h"
 #include "BMobaTriggerCapsule.h"
 #include "BattleMobaCTF.h"
+#include "MobaHitboxSet.h"
+#include "MobaCombatTraceBatcher.h"
+#include "CombatSubsystem.h"
+#include "MobaCosmeticChannel.h"
+#include "MobaParticlePool.h"
+#include "MobaRagdollBudget.h"
+#include "MobaWorldRegistry.h"
+#include "MobaNameplateOcclusion.h"
+#include "MobaWidgetManager.h"
+#include "MobaCombatLog.h"
+#include "MobaNetAccounting.h"
+#include "BattleMoba.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaCharacterTick, "Character Tick");
+MOBA_DECLARE_HOT_PATH(STAT_MobaTargetDetection, "Target Detection");
+MOBA_DECLARE_HOT_PATH(STAT_MobaDamageResolution, "Damage Resolution");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ServerRotateToCameraView, "RPC ServerRotateToCameraView");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_StunPlayerServer, "RPC StunPlayerServer");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_StunPlayerClient, "RPC StunPlayerClient");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ServerRotateHitActor, "RPC ServerRotateHitActor");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ServerSpawnEffect, "RPC ServerSpawnEffect");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_SetActiveSocket, "RPC SetActiveSocket");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ServerCounterAttack, "RPC ServerCounterAttack");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_MulticastCounterAttack, "RPC MulticastCounterAttack");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_RespawnCharacter, "RPC RespawnCharacter");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_RotateNearestTarget, "RPC RotateNearestTarget");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_SafeZoneServer, "RPC SafeZoneServer");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_SafeZoneMulticast, "RPC SafeZoneMulticast");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_MulticastExecuteAction, "RPC MulticastExecuteAction");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ServerAttackTrace, "RPC ServerAttackTrace");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ServerFireTrace, "RPC ServerFireTrace");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ServerSetMaxWalkSpeed, "RPC ServerSetMaxWalkSpeed");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ServerExecuteAction, "RPC ServerExecuteAction");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ServerChooseBattleStyle, "RPC ServerChooseBattleStyle");
+
+FMobaSkillButtonDelegate ABattleMobaCharacter::OnSkillButton;
 
 
 void ABattleMobaCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -59,18 +95,31 @@ void ABattleMobaCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 	DOREPLIFETIME(ABattleMobaCharacter, currentTarget);
 	DOREPLIFETIME(ABattleMobaCharacter, CounterMoveset);
 	DOREPLIFETIME(ABattleMobaCharacter, HitEffect);
-	DOREPLIFETIME(ABattleMobaCharacter, CTFteam);
-	DOREPLIFETIME(ABattleMobaCharacter, CTFentering);
 	DOREPLIFETIME(ABattleMobaCharacter, ActorsToGetGold);
 	DOREPLIFETIME(ABattleMobaCharacter, closestActor);
 	DOREPLIFETIME(ABattleMobaCharacter, RotateToActor);
 	DOREPLIFETIME(ABattleMobaCharacter, IsStunned);
 	DOREPLIFETIME(ABattleMobaCharacter, OnSpecialAttack);
-	DOREPLIFETIME(ABattleMobaCharacter, ActiveColliders);
 	DOREPLIFETIME(ABattleMobaCharacter, ArrDamagedEnemy);
 	DOREPLIFETIME(ABattleMobaCharacter, bApplyHitTrace);
 	DOREPLIFETIME(ABattleMobaCharacter, comboCount);
 	DOREPLIFETIME(ABattleMobaCharacter, MaxHealth);
+	DOREPLIFETIME(ABattleMobaCharacter, HitReactions);
+	DOREPLIFETIME(ABattleMobaCharacter, RespawnCount);
+	DOREPLIFETIME_CONDITION(ABattleMobaCharacter, SkillReadyTimes, COND_OwnerOnly);
+	DOREPLIFETIME(ABattleMobaCharacter, ActionTable);
+}
+
+bool ABattleMobaCharacter::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	UMobaNetAccounting::RecordRpcFor(this, Function, Parameters);
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void ABattleMobaCharacter::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+	UMobaNetAccounting::RecordPropertiesFor(this);
 }
 
 ABattleMobaCharacter::ABattleMobaCharacter()
@@ -118,193 +167,6 @@ ABattleMobaCharacter::ABattleMobaCharacter()
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named MyCharacter (to avoid direct content references in C++)
 
-	LeftKickCol = CreateDefaultSubobject<UBoxComponent>(TEXT("LeftKickCol"));
-	LeftKickCol->SetupAttachment(GetMesh(), "calf_twist_01_l");
-	LeftKickCol->SetRelativeLocation(FVector(-5.0f, 0.0f, 0.0f));
-	LeftKickCol->SetRelativeRotation(FRotator(0.0f, 180.0f, 90.0f));
-	LeftKickCol->SetBoxExtent(FVector(20.0f, 5.0f, 5.0f));
-	LeftKickCol->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LKC1 = CreateDefaultSubobject<UBoxComponent>(TEXT("LKC1"));
-	LKC1->SetupAttachment(LeftKickCol);
-	LKC1->SetRelativeLocation(FVector(-15.0f, 0.0f, 0.0f));
-	LKC1->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LKC1->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LKC2 = CreateDefaultSubobject<UBoxComponent>(TEXT("LKC2"));
-	LKC2->SetupAttachment(LeftKickCol);
-	LKC2->SetRelativeLocation(FVector(-8.0f, 0.0f, 0.0f));
-	LKC2->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LKC2->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LKC3 = CreateDefaultSubobject<UBoxComponent>(TEXT("LKC3"));
-	LKC3->SetupAttachment(LeftKickCol);
-	LKC3->SetRelativeLocation(FVector(-1.0f, 0.0f, 0.0f));
-	LKC3->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LKC3->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LKC4 = CreateDefaultSubobject<UBoxComponent>(TEXT("LKC4"));
-	LKC4->SetupAttachment(LeftKickCol);
-	LKC4->SetRelativeLocation(FVector(5.0f, 0.0f, 0.0f));
-	LKC4->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LKC4->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LKC5 = CreateDefaultSubobject<UBoxComponent>(TEXT("LKC5"));
-	LKC5->SetupAttachment(LeftKickCol);
-	LKC5->SetRelativeLocation(FVector(10.0f, 0.0f, 0.0f));
-	LKC5->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LKC5->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LKC6 = CreateDefaultSubobject<UBoxComponent>(TEXT("LKC6"));
-	LKC6->SetupAttachment(LeftKickCol);
-	LKC6->SetRelativeLocation(FVector(16.0f, 0.0f, 0.0f));
-	LKC6->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LKC6->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RightKickCol = CreateDefaultSubobject<UBoxComponent>(TEXT("RightKickCol"));
-	RightKickCol->SetupAttachment(GetMesh(), "calf_twist_01_r");
-	RightKickCol->SetRelativeLocation(FVector(5.0f, 0.0f, 0.0f));
-	RightKickCol->SetRelativeRotation(FRotator(0.0f, 0.0f, 90.0f));
-	RightKickCol->SetBoxExtent(FVector(20.0f, 5.0f, 5.0f));
-	RightKickCol->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RKC1 = CreateDefaultSubobject<UBoxComponent>(TEXT("RKC1"));
-	RKC1->SetupAttachment(RightKickCol);
-	RKC1->SetRelativeLocation(FVector(-15.0f, 0.0f, 0.0f));
-	RKC1->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RKC1->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RKC2 = CreateDefaultSubobject<UBoxComponent>(TEXT("RKC2"));
-	RKC2->SetupAttachment(RightKickCol);
-	RKC2->SetRelativeLocation(FVector(-8.0f, 0.0f, 0.0f));
-	RKC2->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RKC2->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RKC3 = CreateDefaultSubobject<UBoxComponent>(TEXT("RKC3"));
-	RKC3->SetupAttachment(RightKickCol);
-	RKC3->SetRelativeLocation(FVector(-1.0f, 0.0f, 0.0f));
-	RKC3->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RKC3->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RKC4 = CreateDefaultSubobject<UBoxComponent>(TEXT("RKC4"));
-	RKC4->SetupAttachment(RightKickCol);
-	RKC4->SetRelativeLocation(FVector(5.0f, 0.0f, 0.0f));
-	RKC4->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RKC4->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RKC5 = CreateDefaultSubobject<UBoxComponent>(TEXT("RKC5"));
-	RKC5->SetupAttachment(RightKickCol);
-	RKC5->SetRelativeLocation(FVector(10.0f, 0.0f, 0.0f));
-	RKC5->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RKC5->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RKC6 = CreateDefaultSubobject<UBoxComponent>(TEXT("RKC6"));
-	RKC6->SetupAttachment(RightKickCol);
-	RKC6->SetRelativeLocation(FVector(16.0f, 0.0f, 0.0f));
-	RKC6->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RKC6->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LKickArrow = CreateDefaultSubobject<UArrowComponent>(TEXT("LKickArrow"));
-	LKickArrow->SetupAttachment(LeftKickCol);
-	LKickArrow->SetRelativeRotation(FRotator(0.0f, 0.0f, 0.0f));
-
-	RKickArrow = CreateDefaultSubobject<UArrowComponent>(TEXT("RKickArrow"));
-	RKickArrow->SetupAttachment(RightKickCol);
-	RKickArrow->SetRelativeRotation(FRotator(0.0f, 0.0f, 0.0f));
-
-	LeftPunchCol = CreateDefaultSubobject<UBoxComponent>(TEXT("LeftPunchCol"));
-	LeftPunchCol->SetupAttachment(GetMesh(), "hand_l");
-	LeftPunchCol->SetRelativeLocation(FVector(0.0f, 0.0f, 0.0f));
-	LeftPunchCol->SetRelativeRotation(FRotator(0.0f, 0.0f, 0.0f));
-	LeftPunchCol->SetBoxExtent(FVector(20.0f, 5.0f, 5.0f));
-	LeftPunchCol->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LPC1 = CreateDefaultSubobject<UBoxComponent>(TEXT("LPC1"));
-	LPC1->SetupAttachment(LeftPunchCol);
-	LPC1->SetRelativeLocation(FVector(-15.0f, 0.0f, 0.0f));
-	LPC1->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LPC1->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LPC2 = CreateDefaultSubobject<UBoxComponent>(TEXT("LPC2"));
-	LPC2->SetupAttachment(LeftPunchCol);
-	LPC2->SetRelativeLocation(FVector(-10.0f, 0.0f, 0.0f));
-	LPC2->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LPC2->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LPC3 = CreateDefaultSubobject<UBoxComponent>(TEXT("LPC3"));
-	LPC3->SetupAttachment(LeftPunchCol);
-	LPC3->SetRelativeLocation(FVector(-5.0f, 0.0f, 0.0f));
-	LPC3->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LPC3->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LPC4 = CreateDefaultSubobject<UBoxComponent>(TEXT("LPC4"));
-	LPC4->SetupAttachment(LeftPunchCol);
-	LPC4->SetRelativeLocation(FVector(0.0f, 0.0f, 0.0f));
-	LPC4->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LPC4->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LPC5 = CreateDefaultSubobject<UBoxComponent>(TEXT("LPC5"));
-	LPC5->SetupAttachment(LeftPunchCol);
-	LPC5->SetRelativeLocation(FVector(5.0f, 0.0f, 0.0f));
-	LPC5->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LPC5->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LPC6 = CreateDefaultSubobject<UBoxComponent>(TEXT("LPC6"));
-	LPC6->SetupAttachment(LeftPunchCol);
-	LPC6->SetRelativeLocation(FVector(10.0f, 0.0f, 0.0f));
-	LPC6->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	LPC6->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RightPunchCol = CreateDefaultSubobject<UBoxComponent>(TEXT("RightPunchCol"));
-	RightPunchCol->SetupAttachment(GetMesh(), "hand_r");
-	RightPunchCol->SetRelativeLocation(FVector(0.0f, 0.0f, 0.0f));
-	RightPunchCol->SetRelativeRotation(FRotator(180.0f, 0.0f, 0.0f));
-	RightPunchCol->SetBoxExtent(FVector(20.0f, 5.0f, 5.0f));
-	RightPunchCol->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RPC1 = CreateDefaultSubobject<UBoxComponent>(TEXT("RPC1"));
-	RPC1->SetupAttachment(RightPunchCol);
-	RPC1->SetRelativeLocation(FVector(-15.0f, 0.0f, 0.0f));
-	RPC1->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RPC1->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RPC2 = CreateDefaultSubobject<UBoxComponent>(TEXT("RPC2"));
-	RPC2->SetupAttachment(RightPunchCol);
-	RPC2->SetRelativeLocation(FVector(-10.0f, 0.0f, 0.0f));
-	RPC2->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RPC2->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RPC3 = CreateDefaultSubobject<UBoxComponent>(TEXT("RPC3"));
-	RPC3->SetupAttachment(RightPunchCol);
-	RPC3->SetRelativeLocation(FVector(-5.0f, 0.0f, 0.0f));
-	RPC3->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RPC3->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RPC4 = CreateDefaultSubobject<UBoxComponent>(TEXT("RPC4"));
-	RPC4->SetupAttachment(RightPunchCol);
-	RPC4->SetRelativeLocation(FVector(0.0f, 0.0f, 0.0f));
-	RPC4->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RPC4->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RPC5 = CreateDefaultSubobject<UBoxComponent>(TEXT("RPC5"));
-	RPC5->SetupAttachment(RightPunchCol);
-	RPC5->SetRelativeLocation(FVector(5.0f, 0.0f, 0.0f));
-	RPC5->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RPC5->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	RPC6 = CreateDefaultSubobject<UBoxComponent>(TEXT("RPC6"));
-	RPC6->SetupAttachment(RightPunchCol);
-	RPC6->SetRelativeLocation(FVector(10.0f, 0.0f, 0.0f));
-	RPC6->SetBoxExtent(FVector(3.0f, 5.0f, 5.0f));
-	RPC6->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-
-	LPunchArrow = CreateDefaultSubobject<UArrowComponent>(TEXT("LPunchArrow"));
-	LPunchArrow->SetupAttachment(GetMesh(), "lowerarm_l");
-
-	RPunchArrow = CreateDefaultSubobject<UArrowComponent>(TEXT("RPunchArrow"));
-	RPunchArrow->SetupAttachment(GetMesh(), "lowerarm_r");
-	RPunchArrow->SetRelativeRotation(FRotator(0, -180, 0));
-
 	//WidgetComponent
 	W_DamageOutput = CreateDefaultSubobject<UWidgetComponent>(TEXT("W_DamageOutput"));
 	W_DamageOutput->SetupAttachment(RootComponent);
@@ -318,6 +180,8 @@ ABattleMobaCharacter::ABattleMobaCharacter()
 	//W_DamageOutput->SetVisibility(false);
 	W_DamageOutput->SetGenerateOverlapEvents(false);
 
+	HealthWidget = FMobaWidgetBinding(TEXT("HealthText"), TEXT("HPBar"), TEXT("TeamName"));
+
 	TraceDistance = 20.0f;
 
 	static ConstructorHelpers::FObjectFinder<UDataTable> FindSltDT(TEXT("DataTable'/Game/Storage/DT_Slt.DT_Slt'"));
@@ -347,24 +211,25 @@ ABattleMobaCharacter::ABattleMobaCharacter()
 
 void ABattleMobaCharacter::OnRep_Health()
 {
-	UUserWidget* HPWidget = Cast<UUserWidget>(W_DamageOutput->GetUserWidgetObject());
-	if (HPWidget)
-	{
-		GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Blue, FString::Printf(TEXT("Player %s with %s Widget"), *GetDebugName(this), *HPWidget->GetFName().ToString()));
-		const FName hptext = FName(TEXT("HealthText"));
-		UTextBlock* HealthText = (UTextBlock*)(HPWidget->WidgetTree->FindWidget(hptext));
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetUpdate);
 
-		const FName hpbar = FName(TEXT("HPBar"));
-		UProgressBar* HealthBar = (UProgressBar*)(HPWidget->WidgetTree->FindWidget(hpbar));
+	MOBA_COMBAT_EVENT(HealthChanged, this, 0, this->Health, this->MaxHealth);
 
-		if (HealthText)
-		{
-			FString TheFloatStr = FString::SanitizeFloat(this->Health);
+	if (HealthWidget.Bind(W_DamageOutput))
+	{
+		HealthWidget.SetValue(this->Health);
+		HealthWidget.SetPercent(this->Health / this->MaxHealth);
+	}
 
-			HealthText->SetText(FText::FromString(TheFloatStr));
-			HealthBar->SetPercent(FMath::Clamp(this->Health / this->MaxHealth, 0.0f, 1.0f));
+	//		the damage number is the drop since the last health this machine saw, so it needs no extra replication
+	if (this->ShownHealth > this->Health && this->FloatingDamageClass != nullptr)
+	{
+		if (UMobaWidgetManager* WidgetManager = GetWorld()->GetSubsystem<UMobaWidgetManager>())
+		{
+			WidgetManager->ShowFloatingText(this->FloatingDamageClass, W_DamageOutput->GetComponentLocation(), this->ShownHealth - this->Health);
 		}
 	}
+	this->ShownHealth = this->Health;
 	//this->Health = UGestureInputsFunctions::UpdateProgressBarComponent(this->WidgetHUD, "HPBar", "Health", "HP", "Pain Meter", this->Health, this->MaxHealth);
 
 	/*if (this->IsLocallyControlled())
@@ -413,11 +278,62 @@ void ABattleMobaCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
+	//Built once, the attack traces only ever ignore ourselves
+	AttackTraceParams = FCollisionQueryParams(SCENE_QUERY_STAT(AttackTrace), false, this);
+
+	MeshRelativeTransform = GetMesh()->GetRelativeTransform();
+	MeshCollisionProfile = GetMesh()->GetCollisionProfileName();
+
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Register(this, TeamName);
+	}
+
+	if (UMobaWidgetManager* WidgetManager = GetWorld()->GetSubsystem<UMobaWidgetManager>())
+	{
+		WidgetManager->RegisterWidget(W_DamageOutput);
+	}
+
 	RefreshPlayerData();
 }
 
+void ABattleMobaCharacter::PostNetInit()
+{
+	Super::PostNetInit();
+
+	//		the initial bunch may carry no reactions at all, the next one received is then a new hit
+	this->bHitReactionsSynced = true;
+}
+
+void ABattleMobaCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Unregister(this);
+	}
+
+	if (UMobaRagdollBudget* Ragdolls = GetWorld()->GetSubsystem<UMobaRagdollBudget>())
+	{
+		Ragdolls->ReleaseRagdoll(this->GetMesh());
+	}
+
+	if (UMobaNameplateOcclusion* Occlusion = GetWorld()->GetSubsystem<UMobaNameplateOcclusion>())
+	{
+		Occlusion->Untrack(W_DamageOutput);
+	}
+
+	if (UMobaWidgetManager* WidgetManager = GetWorld()->GetSubsystem<UMobaWidgetManager>())
+	{
+		WidgetManager->UnregisterWidget(W_DamageOutput);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 float ABattleMobaCharacter::TakeDamage(float Damage, FDamageEvent const & DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaDamageResolution);
+
 	if (this->GetLocalRole() == ROLE_Authority)
 	{
 		if (DamageCauser != this)
@@ -430,12 +346,10 @@ float ABattleMobaCharacter::TakeDamage(float Damage, FDamageEvent const & Damage
 			}
 			this->DamageDealers.Emplace(ps);
 
-			ServerSpawnEffect(damageChar, this);
-			
-
 			if (damageChar->OnSpecialAttack == true)
 			{
-				HitReactionClient(this, Damage, this->HitReactionMoveset, "NormalHit01");
+				ReceiveHit(damageChar, Damage, EMobaHitDirection::Special, "NormalHit01");
+				MOBA_COMBAT_EVENT(HitReceived, this, int32(EMobaHitDirection::Special), Damage);
 			}
 
 			else if (damageChar->OnSpecialAttack == false)
@@ -453,29 +367,29 @@ float ABattleMobaCharacter::TakeDamage(float Damage, FDamageEvent const & Damage
 				// right
 				if (UKismetMathLibrary::InRange_FloatFloat(RotDifference.Yaw, -135.0f, -45.0f, true, true))
 				{
-					HitReactionClient(this, Damage, this->RightHitMoveset, HitSection);
-					GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Yellow, FString::Printf(TEXT("Hit from RIGHT")));
+					ReceiveHit(damageChar, Damage, EMobaHitDirection::Right, HitSection);
+					MOBA_COMBAT_EVENT(HitReceived, this, int32(EMobaHitDirection::Right), Damage);
 				}
 
 				// front
 				else if (UKismetMathLibrary::InRange_FloatFloat(RotDifference.Yaw, -45.0f, 45.0f, true, true))
 				{
-					HitReactionClient(this, Damage, this->FrontHitMoveset, HitSection);
-					GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Yellow, FString::Printf(TEXT("Hit from FRONT")));
+					ReceiveHit(damageChar, Damage, EMobaHitDirection::Front, HitSection);
+					MOBA_COMBAT_EVENT(HitReceived, this, int32(EMobaHitDirection::Front), Damage);
 				}
 
 				//	left
 				else if (UKismetMathLibrary::InRange_FloatFloat(RotDifference.Yaw, 45.0f, 135.0f, true, true))
 				{
-					HitReactionClient(this, Damage, this->LeftHitMoveset, HitSection);
-					GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Yellow, FString::Printf(TEXT("Hit from LEFT")));
+					ReceiveHit(damageChar, Damage, EMobaHitDirection::Left, HitSection);
+					MOBA_COMBAT_EVENT(HitReceived, this, int32(EMobaHitDirection::Left), Damage);
 				}
 
 				//	back
 				else
 				{
-					HitReactionClient(this, Damage, this->BackHitMoveset, HitSection);
-					GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Yellow, FString::Printf(TEXT("Hit from BACK")));
+					ReceiveHit(damageChar, Damage, EMobaHitDirection::Back, HitSection);
+					MOBA_COMBAT_EVENT(HitReceived, this, int32(EMobaHitDirection::Back), Damage);
 				}
 
 			}
@@ -497,16 +411,8 @@ void ABattleMobaCharacter::RefreshPlayerData()
 		ActionTable = PS->ActionTable;
 		MaxHealth = PS->MaxHealth;
 
-		FString Context;
-		for (auto& name : ActionTable->GetRowNames())
-		{
-			FActionSkill* row = ActionTable->FindRow<FActionSkill>(name, Context);
-
-			if (row)
-			{
-				row->isOnCD = false;
-			}
-		}
+		BuildSkillIndex();
+		ResetSkillCooldowns();
 	}
 
 	this->GetMesh()->SetSkeletalMesh(CharMesh, false);
@@ -516,7 +422,7 @@ void ABattleMobaCharacter::RefreshPlayerData()
 	FTimerDelegate TimerDelegate;
 
 	//set the row boolean to false after finish cooldown timer
-	TimerDelegate.BindLambda([this]()
+	TimerDelegate.BindWeakLambda(this, [this]()
 	{
 		this->GetMesh()->SetVisibility(true);
 
@@ -536,9 +442,9 @@ void ABattleMobaCharacter::RefreshPlayerData()
 	});
 	this->GetWorldTimerManager().SetTimer(handle, TimerDelegate, 1.0f, false);
 
-	for (TActorIterator<ABattleMobaCTF> It(GetWorld()); It; ++It)
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
 	{
-		Towers.Add(*It);
+		Towers = Registry->GetAll<ABattleMobaCTF>();
 	}
 
 	CreateCPHUD();
@@ -558,7 +464,7 @@ void ABattleMobaCharacter::CheckSwipeType(EInputType Type, FVector2D Location, T
 				//if current Location is on the left side of screen, set swipe mechanic to move the player, else set to rotate the camera
 				if (UInputLibrary::PointOnLeftHalfOfScreen(Location))
 				{
-					GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, FString::Printf(TEXT("Move")));
+					MOBA_COMBAT_EVENT(SwipeInput, this, int32(TouchIndex), Location.X, Location.Y);
 
 					TouchStart = Location;
 					MoveTouchIndex = TouchIndex;
@@ -574,7 +480,7 @@ void ABattleMobaCharacter::CheckSwipeType(EInputType Type, FVector2D Location, T
 				//if current Location is on the left side of screen, set swipe mechanic to move the player, else set to rotate the camera
 				if (UInputLibrary::PointOnLeftHalfOfScreen(Location))
 				{
-					GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, FString::Printf(TEXT("Move")));
+					MOBA_COMBAT_EVENT(SwipeInput, this, int32(TouchIndex), Location.X, Location.Y);
 
 					TouchStart = Location;
 					MoveTouchIndex = TouchIndex;
@@ -594,7 +500,7 @@ void ABattleMobaCharacter::CheckSwipeType(EInputType Type, FVector2D Location, T
 				//if current Location is on the left side of screen, set swipe mechanic to move the player, else set to rotate the camera
 				if (UInputLibrary::PointOnLeftHalfOfScreen(Location))
 				{
-					GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, FString::Printf(TEXT("Move")));
+					MOBA_COMBAT_EVENT(SwipeInput, this, int32(TouchIndex), Location.X, Location.Y);
 
 					TouchEnd = Location;
 					MoveTouchIndex = TouchIndex;
@@ -609,7 +515,7 @@ void ABattleMobaCharacter::CheckSwipeType(EInputType Type, FVector2D Location, T
 				//if current Location is on the left side of screen, set swipe mechanic to move the player, else set to rotate the camera
 				if (UInputLibrary::PointOnLeftHalfOfScreen(Location))
 				{
-					GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, FString::Printf(TEXT("Move")));
+					MOBA_COMBAT_EVENT(SwipeInput, this, int32(TouchIndex), Location.X, Location.Y);
 
 					TouchEnd = Location;
 					MoveTouchIndex = TouchIndex;
@@ -645,11 +551,38 @@ void ABattleMobaCharacter::CheckSwipeType(EInputType Type, FVector2D Location, T
 
 void ABattleMobaCharacter::Tick(float DeltaTime)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaCharacterTick);
+
 	Super::Tick(DeltaTime);
 
-	if (WithinVicinity)
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		PoseHistory.Record(GetWorld()->GetTimeSeconds(), this->GetMesh()->GetComponentTransform());
+	}
+
+	//		play a buffered combo press once the current section allows it
+	if (BufferedComboSkill != INDEX_NONE && GetWorld()->GetTimeSeconds() >= ComboReadyTime)
+	{
+		const uint8 SkillId = uint8(BufferedComboSkill);
+		BufferedComboSkill = INDEX_NONE;
+		AdvanceCombo(SkillId, GetWorld()->GetTimeSeconds());
+	}
+
+	//		the occlusion sweeps themselves are budgeted across all nameplates by UMobaNameplateOcclusion
+	if (WithinVicinity != bNameplateTracked)
 	{
-		UInputLibrary::SetUIVisibility(W_DamageOutput, this);
+		bNameplateTracked = WithinVicinity;
+		if (UMobaNameplateOcclusion* Occlusion = GetWorld()->GetSubsystem<UMobaNameplateOcclusion>())
+		{
+			if (bNameplateTracked)
+			{
+				Occlusion->Track(W_DamageOutput, this);
+			}
+			else
+			{
+				Occlusion->Untrack(W_DamageOutput);
+			}
+		}
 	}
 
 	////////////////Mobile Input/////////////////////////////
@@ -733,7 +666,7 @@ void ABattleMobaCharacter::AddSwipeVectorToMovementInput()
 	//rotate a vector from YawRotation
 	const FVector Direction = YawRotation.RotateVector(WorldDirection);
 
-	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("Enable move")));
+	MOBA_COMBAT_EVENT(MoveInput, this, 0, Direction.X, Direction.Y);
 	
 	//Move character based on world direction
 	AddMovementInput(Direction, -1.0f);
@@ -777,31 +710,12 @@ bool ABattleMobaCharacter::ServerRotateToCameraView_Validate(FRotator InRot)
 
 void ABattleMobaCharacter::ServerRotateToCameraView_Implementation(FRotator InRot)
 {
-	RotateToCameraView(InRot);
-}
-
-bool ABattleMobaCharacter::RotateToCameraView_Validate(FRotator InRot)
-{
-	return true;
-}
-
-void ABattleMobaCharacter::RotateToCameraView_Implementation(FRotator InRot)
-{
-	//Multicast rotation
-	FMath::RInterpTo(this->GetCapsuleComponent()->GetComponentRotation(), InRot, GetWorld()->GetDeltaSeconds(), 10.0f);
-	this->SetActorRotation(InRot);
-
-	//setting up for cooldown properties
-	//FTimerHandle handle;
-	//FTimerDelegate TimerDelegate;
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ServerRotateToCameraView);
 
-	////set the row boolean to false after finish cooldown timer
-	//TimerDelegate.BindLambda([this]()
-	//{
-	//	Rotate = false;
-	//	GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, FString::Printf(TEXT("Rotate: %s"), Rotate ? TEXT("true") : TEXT("false")));
-	//});
-	//this->GetWorldTimerManager().SetTimer(handle, TimerDelegate, 1.0f, false);
+	if (UMobaCosmeticChannel* Cosmetics = GetWorld()->GetSubsystem<UMobaCosmeticChannel>())
+	{
+		Cosmetics->QueueRotation(this, InRot);
+	}
 }
 
 void ABattleMobaCharacter::SetupWidget()
@@ -834,9 +748,10 @@ void ABattleMobaCharacter::SetupWidget()
 
 void ABattleMobaCharacter::HideHPBar()
 {
-	if (WithinVicinity)
+	UMobaNameplateOcclusion* Occlusion = GetWorld()->GetSubsystem<UMobaNameplateOcclusion>();
+	if (WithinVicinity && Occlusion)
 	{
-		UInputLibrary::SetUIVisibility(W_DamageOutput, this);
+		Occlusion->Refresh(W_DamageOutput);
 		/*FHit(ForceInit);
 
 		FVector start = this->GetActorLocation();
@@ -855,131 +770,170 @@ void ABattleMobaCharacter::HideHPBar()
 	}
 }
 
-bool ABattleMobaCharacter::HitReactionServer_Validate(AActor * HitActor, float DamageReceived, UAnimMontage* HitMoveset, FName MontageSection)
+void ABattleMobaCharacter::ReceiveHit(ABattleMobaCharacter* Attacker, float DamageReceived, EMobaHitDirection Direction, FName MontageSection)
 {
-	return true;
-}
+	if (this->InRagdoll == true || this->Health <= 0.0f)
+	{
+		return;
+	}
 
-void ABattleMobaCharacter::HitReactionServer_Implementation(AActor* HitActor, float DamageReceived, UAnimMontage* HitMoveset, FName MontageSection)
-{
-	if (this->GetLocalRole() == ROLE_Authority)
+	float Temp = this->Health - DamageReceived;
+
+	/**		Knockout and respawn*/
+	const bool bKnockout = Temp <= 0.0f;
+	if (bKnockout)
 	{
-		if (HitActor == this)
+		Temp = 0.0f;
+
+		FTimerHandle handle;
+		FTimerDelegate TimerDelegate;
+
+		ABattleMobaGameMode* gm = Cast<ABattleMobaGameMode>(UGameplayStatics::GetGameMode(this));
+
+		//Set player's death count
+		ABattleMobaPlayerState* ps = Cast<ABattleMobaPlayerState>(this->GetPlayerState());
+
+		TimerDelegate.BindWeakLambda(this, [this, gm, ps]()
+		{
+			if (gm)
+			{
+				gm->PlayerKilled(ps, this->DamageDealers.Last(), DamageDealers); //Set current team scores and kills
+			}
+		});
+		this->GetWorldTimerManager().SetTimer(handle, TimerDelegate, 0.02f, false);
+
+		if (gm)
 		{
-			HitReactionClient(HitActor, DamageReceived, HitMoveset, MontageSection);
+			//Start Respawn Timer Count
+			gm->StartRespawnTimer(ps);
 		}
+		this->GetWorld()->GetTimerManager().SetTimer(this->RespawnTimer, this, &ABattleMobaCharacter::RespawnCharacter, 3.0f, false);
 	}
-}
+	this->Health = Temp;
+	this->IsHit = false;
 
-bool ABattleMobaCharacter::HitReactionClient_Validate(AActor* HitActor, float DamageReceived, UAnimMontage* HitMoveset, FName MontageSection)
-{
-	return true;
+	//run clear damage dealers array
+	this->GetWorldTimerManager().SetTimer(this->DealerTimer, this, &ABattleMobaCharacter::ClearDamageDealers, 5.0f, true);
+
+	/**		hits of the same frame are folded into one reaction, clients get a single update*/
+	FMobaHitReaction* Reaction = nullptr;
+	if (this->LastHitReactionFrame == GFrameCounter && this->HitReactions.Items.Num() > 0)
+	{
+		Reaction = this->HitReactions.GetLatest();
+	}
+	else
+	{
+		this->LastHitReactionFrame = GFrameCounter;
+		Reaction = &this->HitReactions.Push();
+	}
+
+	UAnimMontage* HitMoveset = Attacker ? Attacker->GetHitMoveset(Direction) : nullptr;
+	const int32 SectionIndex = HitMoveset ? HitMoveset->GetSectionIndex(MontageSection) : INDEX_NONE;
+
+	Reaction->Attacker = Attacker;
+	Reaction->Direction = Direction;
+	Reaction->SectionId = (SectionIndex >= 0 && SectionIndex < MAX_uint8) ? uint8(SectionIndex) : 0;
+	Reaction->bKnockout = bKnockout;
+	this->HitReactions.MarkItemDirty(*Reaction);
+
+	if (UCombatSubsystem* Combat = GetWorld()->GetSubsystem<UCombatSubsystem>())
+	{
+		Combat->MarkDirty(this);
+	}
+
+	OnRep_Health();
+	PlayHitReaction(*Reaction);
 }
 
-void ABattleMobaCharacter::HitReactionClient_Implementation(AActor* HitActor, float DamageReceived, UAnimMontage* HitMoveset, FName MontageSection)
+void ABattleMobaCharacter::OnRep_HitReactions()
 {
-	if (HitActor == this)
+	const FMobaHitReaction* Latest = this->HitReactions.GetLatest();
+
+	//		a pawn that just became relevant only learns where the sequence is, its past hits are not replayed
+	if (!this->bHitReactionsSynced)
 	{
-		if (this->InRagdoll == false)
+		this->bHitReactionsSynced = true;
+		if (Latest != nullptr)
 		{
-			if (this->Health >= 0)
-			{
-				float Temp = this->Health - DamageReceived;
+			this->LastPlayedHitSequence = Latest->Sequence;
+		}
+		return;
+	}
 
-				/**		Knockout and respawn*/
-				if (Temp <= 0.0f)
-				{
-					//Set Team Kills
-					//ABattleMobaGameState* gs = Cast <ABattleMobaGameState>(UGameplayStatics::GetGameState(this));
-					//if (gs)
-					//{
-					//	if (gs->TeamA.Contains(this->GetPlayerState()->GetPlayerName()))
-					//	{
-					//		gs->TeamKillB += 1;
-					//		//gs->OnRep_TeamKillCountB();
-					//	}
-					//	else if (gs->TeamB.Contains(this->GetPlayerState()->GetPlayerName()))
-					//	{
-					//		gs->TeamKillA += 1;
-					//		//gs->OnRep_TeamKillCountA();
-					//	}
-					//	GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("Team A : %d, Team B : %d"), gs->TeamKillA, gs->TeamKillB));
-					//}
-					Temp = 0.0f;
-					
-					//disable action
-					this->ActionEnabled = false;
-					this->WithinVicinity = false;
+	//		only the newest reaction plays, anything older was missed or already played
+	if (Latest != nullptr && FMobaHitReactionArray::IsNewer(Latest->Sequence, this->LastPlayedHitSequence))
+	{
+		PlayHitReaction(*Latest);
+	}
+}
+
+void ABattleMobaCharacter::PlayHitReaction(const FMobaHitReaction& Reaction)
+{
+	this->LastPlayedHitSequence = Reaction.Sequence;
+
+	if (Reaction.bKnockout)
+	{
+		EnterKnockout();
+	}
 
-					//ps->Death += 1;
+	/**		Play hit reaction animation on hit*/
+	UAnimMontage* HitMoveset = Reaction.Attacker ? Reaction.Attacker->GetHitMoveset(Reaction.Direction) : nullptr;
+	if (HitMoveset != nullptr && !Reaction.bKnockout && this->GetMesh()->GetAnimInstance() != nullptr)
+	{
+		this->GetMesh()->GetAnimInstance()->Montage_Play(HitMoveset, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
+		this->GetMesh()->GetAnimInstance()->Montage_JumpToSection(HitMoveset->GetSectionName(Reaction.SectionId));
+	}
 
-					FTimerHandle handle;
-					FTimerDelegate TimerDelegate;
+	if (Reaction.Attacker != nullptr)
+	{
+		Reaction.Attacker->SpawnHitEffect();
+	}
 
-					ABattleMobaGameMode* gm = Cast<ABattleMobaGameMode>(UGameplayStatics::GetGameMode(this));
+	UpdateHUD();
+}
 
-					//Set player's death count
-					ABattleMobaPlayerState* ps = Cast<ABattleMobaPlayerState>(this->GetPlayerState());
+void ABattleMobaCharacter::EnterKnockout()
+{
+	//disable action
+	this->ActionEnabled = false;
+	this->WithinVicinity = false;
 
-					//set the row boolean to false after finish cooldown timer
-					TimerDelegate.BindLambda([this, gm, ps]()
-					{
-						if (gm)
-						{
-							gm->PlayerKilled(ps, this->DamageDealers.Last(), DamageDealers); //Set current team scores and kills
-						}
-					});
+	this->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	this->GetCharacterMovement()->DisableMovement();
 
-					//start cooldown the skill
-					this->GetWorldTimerManager().SetTimer(handle, TimerDelegate, 0.02f, false);
-					
-					this->GetMesh()->SetCollisionEnabled(ECollisionEnabled::PhysicsOnly);
-					this->GetMesh()->SetCollisionObjectType(ECollisionChannel::ECC_PhysicsBody);
-					this->GetMesh()->SetSimulatePhysics(true);
-					this->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-					this->GetCharacterMovement()->DisableMovement();
+	//		the dedicated server only needs the knocked-out state
+	if (this->GetNetMode() == ENetMode::NM_DedicatedServer)
+	{
+		return;
+	}
 
-					if (GetLocalRole() == ROLE_Authority)
-					{
-						//Start Respawn Timer Count
-						gm->StartRespawnTimer(ps);
+	UMobaRagdollBudget* Ragdolls = GetWorld()->GetSubsystem<UMobaRagdollBudget>();
+	if (Ragdolls && Ragdolls->RequestRagdoll(this->GetMesh()))
+	{
+		return;
+	}
 
-						this->GetWorld()->GetTimerManager().SetTimer(this->RespawnTimer, this, &ABattleMobaCharacter::RespawnCharacter, 3.0f, false);
-					}
-				}
-				this->Health = Temp;
-				this->IsHit = false;
-
-				///**		Force player to face Attacker*/
-				//FRotator PlayerRot = UKismetMathLibrary::FindLookAtRotation(this->GetActorLocation(), AttackerLocation);
-				//FRotator NewRot = FMath::RInterpTo(this->GetActorRotation(), PlayerRot, GetWorld()->GetDeltaSeconds(), 200.0f);
-				//FRotator NewRot2 = FRotator(this->GetActorRotation().Pitch, NewRot.Yaw, this->GetActorRotation().Roll);
-				//this->SetActorRotation(NewRot2);
-
-				/**		Play hit reaction animation on hit*/
-				//UAnimMontage* CurrentMontage = this->GetMesh()->GetAnimInstance()->GetCurrentActiveMontage();
-				//this->GetMesh()->GetAnimInstance()->Montage_Stop(0.001f, CurrentMontage);
-				//PlayAnimMontage(HitMoveset, 1.0f, MontageSection);
-				this->GetMesh()->GetAnimInstance()->Montage_Play(HitMoveset, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
-				this->GetMesh()->GetAnimInstance()->Montage_JumpToSection(MontageSection);
-
-				OnRep_Health();
-
-				//run clear damage dealers array
-				if (this->GetWorldTimerManager().IsTimerActive(this->DealerTimer))
-				{
-					this->GetWorldTimerManager().ClearTimer(this->DealerTimer);
+	if (this->DeathPose != nullptr)
+	{
+		this->GetMesh()->PlayAnimation(this->DeathPose, false);
+	}
+}
 
-					if (this->IsLocallyControlled())
-					{
-						SetActiveSocket(NAME_None);
-					}
-				}
-				this->GetWorldTimerManager().SetTimer(this->DealerTimer, this, &ABattleMobaCharacter::ClearDamageDealers, 5.0f, true);
-			}
-		}
+UAnimMontage* ABattleMobaCharacter::GetHitMoveset(EMobaHitDirection Direction) const
+{
+	switch (Direction)
+	{
+	case EMobaHitDirection::Front:
+		return this->FrontHitMoveset;
+	case EMobaHitDirection::Back:
+		return this->BackHitMoveset;
+	case EMobaHitDirection::Left:
+		return this->LeftHitMoveset;
+	case EMobaHitDirection::Right:
+		return this->RightHitMoveset;
+	default:
+		return this->HitReactionMoveset;
 	}
-	UpdateHUD();
 }
 
 bool ABattleMobaCharacter::StunPlayerServer_Validate(bool checkStun)
@@ -989,6 +943,8 @@ bool ABattleMobaCharacter::StunPlayerServer_Validate(bool checkStun)
 
 void ABattleMobaCharacter::StunPlayerServer_Implementation(bool checkStun)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_StunPlayerServer);
+
 	if (this->GetLocalRole() == ROLE_Authority)
 	{
 		StunPlayerClient(checkStun);
@@ -1003,6 +959,8 @@ bool ABattleMobaCharacter::StunPlayerClient_Validate(bool checkStun)
 
 void ABattleMobaCharacter::StunPlayerClient_Implementation(bool checkStun)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_StunPlayerClient);
+
 	/**		called in stun hit reaction montage AnimBP*/
 	this->IsStunned = checkStun;
 
@@ -1011,7 +969,7 @@ void ABattleMobaCharacter::StunPlayerClient_Implementation(bool checkStun)
 		FTimerDelegate TimerDel;
 		FTimerHandle handle;
 
-		TimerDel.BindLambda([this]()
+		TimerDel.BindWeakLambda(this, [this]()
 		{
 			this->IsStunned = false;
 		});
@@ -1028,30 +986,26 @@ bool ABattleMobaCharacter::ServerRotateHitActor_Validate(AActor * HitActor, AAct
 
 void ABattleMobaCharacter::ServerRotateHitActor_Implementation(AActor * HitActor, AActor * Attacker)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ServerRotateHitActor);
+
 	if (this->GetLocalRole() == ROLE_Authority)
 	{
-		if (HitActor == this)
+		if (HitActor == this && Attacker != nullptr)
 		{
-			MulticastRotateHitActor(HitActor, Attacker);
+			/**		Force player to face Attacker*/
+			FRotator hitCharRot = UKismetMathLibrary::FindLookAtRotation(HitActor->GetActorLocation(), Attacker->GetActorLocation());
+			FRotator NewRot = FMath::RInterpTo(HitActor->GetActorRotation(), hitCharRot, HitActor->GetWorld()->GetDeltaSeconds(), 200.0f);
+			FRotator FinalRot = FRotator(HitActor->GetActorRotation().Pitch, NewRot.Yaw, HitActor->GetActorRotation().Roll);
+
+			if (UMobaCosmeticChannel* Cosmetics = GetWorld()->GetSubsystem<UMobaCosmeticChannel>())
+			{
+				Cosmetics->QueueRotation(this, FinalRot);
+			}
 		}
 	}
 	
 }
 
-bool ABattleMobaCharacter::MulticastRotateHitActor_Validate(AActor * HitActor, AActor * Attacker)
-{
-	return true;
-}
-
-void ABattleMobaCharacter::MulticastRotateHitActor_Implementation(AActor * HitActor, AActor * Attacker)
-{
-	/**		Force player to face Attacker*/
-	FRotator hitCharRot = UKismetMathLibrary::FindLookAtRotation(HitActor->GetActorLocation(), Attacker->GetActorLocation());
-	FRotator NewRot = FMath::RInterpTo(HitActor->GetActorRotation(), hitCharRot, HitActor->GetWorld()->GetDeltaSeconds(), 200.0f);
-	FRotator FinalRot = FRotator(HitActor->GetActorRotation().Pitch, NewRot.Yaw, HitActor->GetActorRotation().Roll);
-	HitActor->SetActorRotation(FinalRot);
-}
-
 bool ABattleMobaCharacter::ServerSpawnEffect_Validate(ABattleMobaCharacter * EmitActor, ABattleMobaCharacter* HitActor)
 {
 	return true;
@@ -1059,52 +1013,34 @@ bool ABattleMobaCharacter::ServerSpawnEffect_Validate(ABattleMobaCharacter * Emi
 
 void ABattleMobaCharacter::ServerSpawnEffect_Implementation(ABattleMobaCharacter * EmitActor, ABattleMobaCharacter* HitActor)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ServerSpawnEffect);
+
 	if (this->GetLocalRole() == ROLE_Authority)
 	{
 		if (HitActor == this)
 		{
-			MulticastSpawnEffect(EmitActor, HitActor);
+			if (UMobaCosmeticChannel* Cosmetics = GetWorld()->GetSubsystem<UMobaCosmeticChannel>())
+			{
+				Cosmetics->QueueEffect(EmitActor);
+			}
 		}
 	}
 }
 
-bool ABattleMobaCharacter::MulticastSpawnEffect_Validate(ABattleMobaCharacter * EmitActor, ABattleMobaCharacter* HitActor)
-{
-	return true;
-}
-
-void ABattleMobaCharacter::MulticastSpawnEffect_Implementation(ABattleMobaCharacter * EmitActor, ABattleMobaCharacter* HitActor)
-{
-	if (EmitActor->HitEffect != nullptr)
-	{
-		//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Orange, FString::Printf(TEXT("Particle Effect Spawned")));
-
-		UGameplayStatics::SpawnEmitterAtLocation(EmitActor->GetWorld(), EmitActor->HitEffect, EmitActor->GetMesh()->GetSocketLocation(EmitActor->ActiveSocket), FRotator::ZeroRotator, false);
-	}
-}
-
 bool ABattleMobaCharacter::SetActiveSocket_Validate(FName SocketName)
 {
 	return true;
 }
 void ABattleMobaCharacter::SetActiveSocket_Implementation(FName SocketName)
 {
-	if (this->GetLocalRole() == ROLE_Authority)
-	{
-		MulticastSetActiveSocket(SocketName);
-	}
-}
-
-bool ABattleMobaCharacter::MulticastSetActiveSocket_Validate(FName SocketName)
-{
-	return true;
-}
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_SetActiveSocket);
 
-void ABattleMobaCharacter::MulticastSetActiveSocket_Implementation(FName SocketName)
-{
-	if (SocketName != NAME_None)
+	if (this->GetLocalRole() == ROLE_Authority)
 	{
-		this->ActiveSocket = SocketName;
+		if (UMobaCosmeticChannel* Cosmetics = GetWorld()->GetSubsystem<UMobaCosmeticChannel>())
+		{
+			Cosmetics->QueueActiveSocket(this, SocketName);
+		}
 	}
 }
 
@@ -1120,135 +1056,79 @@ void ABattleMobaCharacter::ClearDamageDealers()
 
 void ABattleMobaCharacter::GetButtonSkillAction(FKey Currkeys, FString ButtonName, bool& cooldown, float& CooldownVal)
 {
+	OnSkillButton.Broadcast(this, Currkeys, ButtonName);
+
 	if (ActionEnabled == true)
 	{
 		if (GetMesh()->SkeletalMesh != nullptr)
 		{
 			if (ActionTable != nullptr)
 			{
-				//Used in error reporting
-				FString Context;
-				for (auto& name : ActionTable->GetRowNames())
+				//		ActionTable can also be swapped from blueprints
+				if (!SkillIndex.IsBuiltFor(ActionTable))
 				{
-					FActionSkill* row = ActionTable->FindRow<FActionSkill>(name, Context);
+					BuildSkillIndex();
+				}
 
-					if (row)
+				const int32 Index = SkillIndex.Find(Currkeys, ButtonName);
+				FActionSkill* row = SkillIndex.GetSkill(Index);
+
+				if (row)
+				{
+					//if current skill is using cooldown
+					if (row->IsUsingCD && !row->UseTranslate)
 					{
-						if (row->keys == Currkeys || row->ButtonName == ButtonName)
+						//if the skill is on cooldown, stop playing the animation, else play the skill animation
+						cooldown = !IsSkillReady(Index);
+						if (cooldown)
 						{
-							//if current skill is using cooldown
-							if (row->IsUsingCD && !row->UseTranslate)
+							MOBA_COMBAT_EVENT(SkillOnCooldown, this, Index);
+						}
+						else if (row->SkillMoveset != nullptr)
+						{
+							TargetHead = row->TargetIsHead;
+							if (this->IsLocallyControlled())
 							{
-								//GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("row->isOnCD: %s"), row->isOnCD ? TEXT("true") : TEXT("false")));
-
-								//if the skill is on cooldown, stop playing the animation, else play the skill animation
-								if (row->isOnCD == true)
-								{
-									//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Current %s skill is on cooldown!!"), ((*name.ToString()))));
-									GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Current %s skill is on cooldown!!"), ((*name.ToString()))));
-									cooldown = row->isOnCD;
-									break;
-								}
-								else if (row->isOnCD == false)
-								{
-									cooldown = row->isOnCD;
-									row->isOnCD = true;
-									//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Current key is %s"), ((*row->keys.ToString()))));
-									if (row->SkillMoveset != nullptr)
-									{
-										TargetHead = row->TargetIsHead;
-										if (this->IsLocallyControlled())
-										{
-											DetectNearestTarget(EResult::Cooldown, *row);
-											AttackSection = "NormalAttack01";
-											//play the animation that visible to all clients
-											//ServerExecuteAction(*row, CurrentSection, AttackSection, true);
-
-											//setting up for cooldown properties
-											FTimerHandle handle;
-											FTimerDelegate TimerDelegate;
-
-											//set the row boolean to false after finish cooldown timer
-											TimerDelegate.BindLambda([row, this]()
-											{
-												UE_LOG(LogTemp, Warning, TEXT("DELAY BEFORE SETTING UP COOLDOWN TO FALSE"));
-												row->isOnCD = false;
-
-												//GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("row->isOnCD: %s"), row->isOnCD ? TEXT("true") : TEXT("false")));
-											});
-
-											//start cooldown the skill
-											this->GetWorldTimerManager().SetTimer(handle, TimerDelegate, row->CDDuration, false);
-											CooldownVal = row->CDDuration;
-											break;
-										}
-									}
-									break;
-								}
+								//		predicted here, the server starts the authoritative cooldown when the skill reaches it
+								StartSkillCooldown(Index);
+								DetectNearestTarget(EResult::Cooldown, uint8(Index));
+								AttackSection = "NormalAttack01";
+								CooldownVal = row->CDDuration;
 							}
+						}
+					}
 
-							/**		current skill uses translation*/
-							else if (row->IsUsingCD && row->UseTranslate)
+					/**		current skill uses translation*/
+					else if (row->IsUsingCD && row->UseTranslate)
+					{
+						cooldown = !IsSkillReady(Index);
+						if (cooldown)
+						{
+							MOBA_COMBAT_EVENT(SkillOnCooldown, this, Index);
+						}
+						else if (row->SkillMoveset != nullptr)
+						{
+							if (this->IsLocallyControlled())
 							{
-								if (row->isOnCD == true)
-								{
-									//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Current %s skill is on cooldown!!"), ((*name.ToString()))));
-									GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Current %s skill is on cooldown!!"), ((*name.ToString()))));
-									cooldown = row->isOnCD;
-									break;
-								}
-								else if (row->isOnCD == false)
-								{
-									cooldown = row->isOnCD;
-									row->isOnCD = true;
-									//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Current key is %s"), ((*row->keys.ToString()))));
-									if (row->SkillMoveset != nullptr)
-									{
-										if (this->IsLocallyControlled())
-										{
-											AttackSection = "NormalAttack01";
-
-											//play the animation that visible to all clients
-											ServerExecuteAction(*row, AttackSection, false);
-
-											//setting up for cooldown properties
-											FTimerHandle handle;
-											FTimerDelegate TimerDelegate;
-
-											//set the row boolean to false after finish cooldown timer
-											TimerDelegate.BindLambda([row, this]()
-											{
-												UE_LOG(LogTemp, Warning, TEXT("DELAY BEFORE SETTING UP COOLDOWN TO FALSE"));
-												row->isOnCD = false;
-
-												//GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("row->isOnCD: %s"), row->isOnCD ? TEXT("true") : TEXT("false")));
-											});
-
-											//start cooldown the skill
-											this->GetWorldTimerManager().SetTimer(handle, TimerDelegate, row->CDDuration, false);
-											CooldownVal = row->CDDuration;
-											break;
-										}
-									}
-									break;
-								}
+								StartSkillCooldown(Index);
+								AttackSection = "NormalAttack01";
+
+								//play the animation that visible to all clients
+								ServerExecuteAction(uint8(Index), GetSkillSectionId(Index, AttackSection), false);
+								CooldownVal = row->CDDuration;
 							}
+						}
+					}
 
-							/**   current skill has combo */
-							else if (row->UseSection)
+					/**   current skill has combo */
+					else if (row->UseSection)
+					{
+						if (row->SkillMoveset != nullptr)
+						{
+							TargetHead = row->TargetIsHead;
+							if (this->IsLocallyControlled())
 							{
-								//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Current key is %s"), ((*row->keys.ToString()))));
-								if (row->SkillMoveset != nullptr)
-								{
-									TargetHead = row->TargetIsHead;
-									if (this->IsLocallyControlled())
-									{
-										DetectNearestTarget(EResult::Section, *row);
-									}
-									/*AttackCombo(*row);*/
-									break;
-
-								}
+								DetectNearestTarget(EResult::Section, uint8(Index));
 							}
 						}
 					}
@@ -1258,25 +1138,46 @@ void ABattleMobaCharacter::GetButtonSkillAction(FKey Currkeys, FString ButtonNam
 	}
 }
 
-void ABattleMobaCharacter::AttackCombo(FActionSkill SelectedRow)
-{	
-	if (this->OnComboDelay == false)
+void ABattleMobaCharacter::AttackCombo(uint8 SkillId)
+{
+	if (FindSkill(SkillId) == nullptr)
 	{
-		this->comboCount = this->comboCount + 1;
+		return;
+	}
 
-		//		Check selected row has many sections in it to determine max combo count
-		if (this->comboCount > SelectedRow.Section)
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	if (Now < this->ComboReadyTime)
+	{
+		//		close enough to the end of the current section, play it as soon as it is ready
+		if (this->ComboReadyTime - Now <= this->ComboInputBuffer)
 		{
-			this->comboCount = 1;
+			this->BufferedComboSkill = SkillId;
 		}
+		return;
+	}
 
-		FString NextSection = UKismetStringLibrary::Concat_StrStr(TEXT("NormalAttack0"), FString::FromInt(comboCount));
-		AttackSection = FName(*NextSection);
+	AdvanceCombo(SkillId, Now);
+}
 
-		if (this->IsLocallyControlled())
-		{
-			ServerExecuteAction(SelectedRow, AttackSection, false);
-		}
+void ABattleMobaCharacter::AdvanceCombo(uint8 SkillId, float Now)
+{
+	const FMobaComboGraph* Combo = SkillIndex.GetCombo(SkillId);
+	if (Combo == nullptr)
+	{
+		return;
+	}
+
+	//		wrap around after the last section of the skill
+	this->comboCount = (this->comboCount % Combo->Steps.Num()) + 1;
+
+	const FMobaComboStep& Step = Combo->Steps[this->comboCount - 1];
+	AttackSection = Step.Section;
+	this->ComboReadyTime = Now + Step.Length + this->comboInterval;
+
+	if (this->IsLocallyControlled())
+	{
+		ServerExecuteAction(SkillId, Step.SectionId, false);
 	}
 }
 
@@ -1287,6 +1188,8 @@ bool ABattleMobaCharacter::ServerCounterAttack_Validate(ABattleMobaCharacter* hi
 
 void ABattleMobaCharacter::ServerCounterAttack_Implementation(ABattleMobaCharacter* hitActor)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ServerCounterAttack);
+
 	MulticastCounterAttack(hitActor);
 }
 
@@ -1297,6 +1200,8 @@ bool ABattleMobaCharacter::MulticastCounterAttack_Validate(ABattleMobaCharacter*
 
 void ABattleMobaCharacter::MulticastCounterAttack_Implementation(ABattleMobaCharacter* hitActor)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_MulticastCounterAttack);
+
 	FName CounterCurrentSection = hitActor->AnimInsta->Montage_GetCurrentSection(hitActor->CounterMoveset);
 
 	/**		If current montage section is CheckInput. go to next available section*/
@@ -1313,7 +1218,7 @@ void ABattleMobaCharacter::MulticastCounterAttack_Implementation(ABattleMobaChar
 		FTimerDelegate TimerDelegate;
 
 		//launch player forward after 0.5s
-		TimerDelegate.BindLambda([this, hitActor]()
+		TimerDelegate.BindWeakLambda(hitActor, [this, hitActor]()
 		{
 			UE_LOG(LogTemp, Warning, TEXT("DELAY BEFORE TRANSLATE CHARACTER FORWARD"));
 
@@ -1334,6 +1239,8 @@ bool ABattleMobaCharacter::RespawnCharacter_Validate()
 
 void ABattleMobaCharacter::RespawnCharacter_Implementation()
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_RespawnCharacter);
+
 	ABattleMobaPC* PC = Cast<ABattleMobaPC>(UGameplayStatics::GetPlayerController(this, 0));
 	if (PC)
 	{
@@ -1354,28 +1261,130 @@ void ABattleMobaCharacter::RespawnCharacter_Implementation()
 	}
 }
 
-void ABattleMobaCharacter::EnableMovementMode()
+void ABattleMobaCharacter::ParkForPool()
 {
-	if (GetMesh()->SkeletalMesh != nullptr)
+	//		every timer is bound to this pawn, including the kill credit and delayed setup, none may fire on the respawned pawn
+	this->GetWorldTimerManager().ClearAllTimersForObject(this);
+
+	if (UMobaCombatTraceBatcher* Batcher = GetWorld()->GetSubsystem<UMobaCombatTraceBatcher>())
 	{
-		if (this->AnimInsta)
-		{
-			this->AnimInsta->CanMove = true;
-		}
+		Batcher->DisarmAttack(this);
 	}
-}
 
-bool ABattleMobaCharacter::DetectNearestTarget_Validate(EResult Type, FActionSkill SelectedRow)
-{
-	return true;
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+
+	//		parked pawns are not live characters, flags and lookups skip them
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Unregister(this);
+	}
 }
 
-void ABattleMobaCharacter::DetectNearestTarget_Implementation(EResult Type, FActionSkill SelectedRow)
+void ABattleMobaCharacter::ResetForRespawn(const FTransform& SpawnTransform)
 {
-	//		create tarray for hit results
-	TArray<FHitResult> hitResults;
+	this->Health = this->MaxHealth;
+	this->InRagdoll = false;
+	this->IsHit = false;
+	this->IsStunned = false;
+	this->DamageDealers.Reset();
+	this->ArrDamagedEnemy.Reset();
 
-	//		start and end locations
+	this->comboCount = 0;
+	this->ComboReadyTime = 0.0f;
+	this->BufferedComboSkill = INDEX_NONE;
+
+	ResetSkillCooldowns();
+	this->PoseHistory.Reset();
+	this->HitReactions.Reset();
+
+	GetCharacterMovement()->Velocity = FVector::ZeroVector;
+	SetActorTransform(FTransform(SpawnTransform.Rotator(), SpawnTransform.GetLocation()), false, nullptr, ETeleportType::ResetPhysics);
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Register(this, TeamName);
+	}
+
+	this->RespawnCount++;
+	OnRep_RespawnCount();
+	OnRep_Health();
+}
+
+void ABattleMobaCharacter::OnRep_RespawnCount()
+{
+	RestoreFromKnockout();
+}
+
+void ABattleMobaCharacter::RestoreFromKnockout()
+{
+	if (UMobaRagdollBudget* Ragdolls = GetWorld()->GetSubsystem<UMobaRagdollBudget>())
+	{
+		Ragdolls->ReleaseRagdoll(this->GetMesh());
+	}
+
+	//		put the mesh back on the capsule, the ragdoll or death pose left it elsewhere
+	USkeletalMeshComponent* CharMeshComp = this->GetMesh();
+	CharMeshComp->SetSimulatePhysics(false);
+	CharMeshComp->SetCollisionProfileName(MeshCollisionProfile);
+	CharMeshComp->AttachToComponent(this->GetCapsuleComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	CharMeshComp->SetRelativeTransform(MeshRelativeTransform);
+
+	if (CharMeshComp->GetAnimationMode() != EAnimationMode::AnimationBlueprint)
+	{
+		CharMeshComp->SetAnimationMode(EAnimationMode::AnimationBlueprint);
+		AnimInsta = Cast<UBattleMobaAnimInstance>(CharMeshComp->GetAnimInstance());
+	}
+
+	this->GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	this->GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Walking);
+
+	//		the owner drives combos itself, a pooled pawn must start them like a fresh spawn
+	if (this->GetLocalRole() == ROLE_AutonomousProxy)
+	{
+		this->comboCount = 0;
+		this->ComboReadyTime = 0.0f;
+		this->BufferedComboSkill = INDEX_NONE;
+	}
+
+	this->ActionEnabled = true;
+	UpdateHUD();
+}
+
+void ABattleMobaCharacter::EnableMovementMode()
+{
+	if (GetMesh()->SkeletalMesh != nullptr)
+	{
+		if (this->AnimInsta)
+		{
+			this->AnimInsta->CanMove = true;
+		}
+	}
+}
+
+bool ABattleMobaCharacter::DetectNearestTarget_Validate(EResult Type, uint8 SkillId)
+{
+	return true;
+}
+
+void ABattleMobaCharacter::DetectNearestTarget_Implementation(EResult Type, uint8 SkillId)
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaTargetDetection);
+
+	if (Type == EResult::Cooldown && !TryStartSkillCooldown(SkillId))
+	{
+		return;
+	}
+
+	//		create tarray for hit results
+	TArray<FHitResult> hitResults;
+
+	//		start and end locations
 	FVector Start = this->GetActorLocation();
 	FVector End = FVector(this->GetActorLocation().X + 0.1f, this->GetActorLocation().Y + 0.1f, this->GetActorLocation().Z + 0.1f);
 
@@ -1451,17 +1460,19 @@ void ABattleMobaCharacter::DetectNearestTarget_Implementation(EResult Type, FAct
 			}
 			//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, FString::Printf(TEXT("Hit Result: %s"), *Hit.Actor->GetName()));
 		}
-		RotateNearestTarget(closestActor, Type, SelectedRow);
+		RotateNearestTarget(closestActor, Type, SkillId);
 	}
 }
 
-bool ABattleMobaCharacter::RotateNearestTarget_Validate(AActor* Target, EResult Type, FActionSkill SelectedRow)
+bool ABattleMobaCharacter::RotateNearestTarget_Validate(AActor* Target, EResult Type, uint8 SkillId)
 {
 	return true;
 }
 
-void ABattleMobaCharacter::RotateNearestTarget_Implementation(AActor* Target, EResult Type, FActionSkill SelectedRow)
+void ABattleMobaCharacter::RotateNearestTarget_Implementation(AActor* Target, EResult Type, uint8 SkillId)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_RotateNearestTarget);
+
 	if (IsValid(Target))
 	{
 		FLatentActionInfo LatentInfo = FLatentActionInfo();
@@ -1488,7 +1499,7 @@ void ABattleMobaCharacter::RotateNearestTarget_Implementation(AActor* Target, ER
 			inst->bMoving = true;
 			inst->Speed = FromOriginToTarget.Size();
 
-			GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, FString::Printf(TEXT("Hit Speed: %f"), inst->Speed));
+			MOBA_COMBAT_EVENT(RotateToTarget, this, 0, inst->Speed);
 
 			//rotate and move the component towards target
 			UKismetSystemLibrary::MoveComponentTo(this->GetCapsuleComponent(), Target->GetActorLocation() + FromOriginToTarget, RotateTo, true, true, 0.1f, true, EMoveComponentAction::Type::Move, LatentInfo);
@@ -1497,7 +1508,7 @@ void ABattleMobaCharacter::RotateNearestTarget_Implementation(AActor* Target, ER
 			FTimerHandle handle;
 			FTimerDelegate TimerDelegate;
 
-			TimerDelegate.BindLambda([this, inst, Type, SelectedRow]()
+			TimerDelegate.BindWeakLambda(this, [this, inst, Type, SkillId]()
 			{
 				//inst->Speed = 0.0f;
 
@@ -1506,11 +1517,11 @@ void ABattleMobaCharacter::RotateNearestTarget_Implementation(AActor* Target, ER
 				{
 					if (Type == EResult::Cooldown)
 					{
-						ServerExecuteAction(SelectedRow, AttackSection, true);
+						ServerExecuteAction(SkillId, GetSkillSectionId(SkillId, AttackSection), true);
 					}
 					else if (Type == EResult::Section)
 					{
-						AttackCombo(SelectedRow);
+						AttackCombo(SkillId);
 					}
 				}
 				inst->bMoving = false;
@@ -1529,11 +1540,11 @@ void ABattleMobaCharacter::RotateNearestTarget_Implementation(AActor* Target, ER
 			{
 				if (Type == EResult::Cooldown)
 				{
-					ServerExecuteAction(SelectedRow, AttackSection, true);
+					ServerExecuteAction(SkillId, GetSkillSectionId(SkillId, AttackSection), true);
 				}
 				else if (Type == EResult::Section)
 				{
-					AttackCombo(SelectedRow);
+					AttackCombo(SkillId);
 				}
 			}
 		}
@@ -1549,11 +1560,11 @@ void ABattleMobaCharacter::RotateNearestTarget_Implementation(AActor* Target, ER
 		{
 			if (Type == EResult::Cooldown)
 			{
-				ServerExecuteAction(SelectedRow, AttackSection, true);
+				ServerExecuteAction(SkillId, GetSkillSectionId(SkillId, AttackSection), true);
 			}
 			else if (Type == EResult::Section)
 			{
-				AttackCombo(SelectedRow);
+				AttackCombo(SkillId);
 			}
 		}
 	}
@@ -1562,67 +1573,34 @@ void ABattleMobaCharacter::RotateNearestTarget_Implementation(AActor* Target, ER
 
 void ABattleMobaCharacter::SafeZone(ABMobaTriggerCapsule* TriggerZone)
 {
-	UUserWidget* HPWidget = Cast<UUserWidget>(TriggerZone->W_Val->GetUserWidgetObject());
-	if (HPWidget)
-	{
-		const FName hpbar = FName(TEXT("PBar"));
-		UProgressBar* PBar = (UProgressBar*)(HPWidget->WidgetTree->FindWidget(hpbar));
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetUpdate);
 
-		const FName hptext = FName(TEXT("ValText"));
-		UTextBlock* HealthText = (UTextBlock*)(HPWidget->WidgetTree->FindWidget(hptext));
-
-		if (PBar)
+	FMobaWidgetBinding& ZoneWidget = TriggerZone->ValueWidget;
+	if (ZoneWidget.Bind(TriggerZone->W_Val))
+	{
+		if (this->IsLocallyControlled())
 		{
-			//FSlateBrush newBrush;
-			if (this->IsLocallyControlled())
+			//Change to progressbar color to blue
+			if (ZoneWidget.GetPercent() <= 0.0f)
 			{
-				//Change to progressbar color to blue
-				if (PBar->Percent <= 0.0f)
-				{
-					PBar->SetFillColorAndOpacity(FLinearColor(0.0f, 0.5f, 1.0f));
-					if (HealthText)
-					{
-						HealthText->SetColorAndOpacity(FLinearColor(0.0f, 0.5f, 1.0f));
-					}
-				}
-				SafeZoneServer(TriggerZone);
+				ZoneWidget.SetColor(FLinearColor(0.0f, 0.5f, 1.0f));
+			}
+			SafeZoneServer(TriggerZone);
+		}
+		else if (ZoneWidget.GetPercent() <= 0.0f)
+		{
+			if (this->TeamName == TriggerZone->TeamName)
+			{
+				//Change progressbar color to red
+				ZoneWidget.SetColor(FLinearColor(1.0f, 0.0f, 0.0f));
 			}
 			else
 			{
-				//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red, FString::Printf(TEXT("Current Team is %s"), ((*Team.ToString()))));
-				//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red, FString::Printf(TEXT("Team is %s"), ((*this->TeamName.ToString()))));
-				if (PBar->Percent <= 0.0f)
-				{
-					if (this->TeamName == TriggerZone->TeamName)
-					{
-						//Change progressbar color to red
-						PBar->SetFillColorAndOpacity(FLinearColor(1.0f, 0.0f, 0.0f));
-						if (HealthText)
-						{
-							HealthText->SetColorAndOpacity(FLinearColor(1.0f, 0.0f, 0.0f));
-						}
-					}
-					else
-					{
-						//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Team is %s"), ((*this->TeamName.ToString()))));
-						//Change progressbar color to red
-						PBar->SetFillColorAndOpacity(FLinearColor(0.0f, 0.5f, 1.0f));
-						if (HealthText)
-						{
-							HealthText->SetColorAndOpacity(FLinearColor(0.0f, 0.5f, 1.0f));
-						}
-						//newBrush.TintColor = FLinearColor(1.0f, 0.0f, 0.0f);
-					}
-				}
+				//Change progressbar color to blue
+				ZoneWidget.SetColor(FLinearColor(0.0f, 0.5f, 1.0f));
 			}
-			//PBar->WidgetStyle.SetBackgroundImage(newBrush);
 		}
 	}
-	//if (IsLocallyControlled())
-	//{
-	//	//Run server safezone
-	//	SafeZoneServer(TriggerZone);
-	//}
 }
 
 bool ABattleMobaCharacter::SafeZoneServer_Validate(ABMobaTriggerCapsule* TriggerZone)
@@ -1632,6 +1610,8 @@ bool ABattleMobaCharacter::SafeZoneServer_Validate(ABMobaTriggerCapsule* Trigger
 
 void ABattleMobaCharacter::SafeZoneServer_Implementation(ABMobaTriggerCapsule* TriggerZone)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_SafeZoneServer);
+
 	//Check if no server timer is running, start the timer, else stop the timer
 	if (GetWorld()->GetTimerManager().IsTimerActive(TriggerZone->FlagTimer) == false)
 	{
@@ -1653,170 +1633,53 @@ bool ABattleMobaCharacter::SafeZoneMulticast_Validate(ABMobaTriggerCapsule* Trig
 
 void ABattleMobaCharacter::SafeZoneMulticast_Implementation(ABMobaTriggerCapsule* TriggerZone)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_SafeZoneMulticast);
+
 	//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Orange, FString::Printf(TEXT("SAFE ZONE??????????")));
 	
 	TriggerZone->val = TriggerZone->val + 1;
 	TriggerZone->OnRep_Val();
 }
 
-void ABattleMobaCharacter::ControlFlagMode(ABattleMobaCTF* cf)
-{
-	if (cf->isCompleted == false)
-	{
-		ABattleMobaGameState* thisGS = Cast<ABattleMobaGameState>(UGameplayStatics::GetGameState(this));
-		if (thisGS)
-		{
-			thisGS->SetTowerWidgetColors(cf);
-		}
-	}
-
-	if (this->IsLocallyControlled())
-	{
-		//Run server Control Flag
-		ControlFlagServer(cf);
-	}
-}
-
-bool ABattleMobaCharacter::ControlFlagServer_Validate(ABattleMobaCTF * cf)
+bool ABattleMobaCharacter::SetupStats_Validate()
 {
 	return true;
 }
 
-void ABattleMobaCharacter::ControlFlagServer_Implementation(ABattleMobaCTF* cf)
+void ABattleMobaCharacter::SetupStats_Implementation()
 {
-	if (cf->RadiantControl > 0 && cf->DireControl == 0)
-	{
-		CTFteam = "Radiant";
-		cf->ControllingSpeed = cf->ConstantSpeed - (cf->SpeedMultiplier * float(cf->RadiantControl));
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Emerald, FString::Printf(TEXT("Capture Speed RADIANT: %f"), cf->ControllingSpeed));
-	}
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetUpdate);
 
-	else if (cf->DireControl > 0 && cf->RadiantControl == 0)
+	if (HealthWidget.Bind(W_DamageOutput))
 	{
-		CTFteam = "Dire";
-		cf->ControllingSpeed = cf->ConstantSpeed - (cf->SpeedMultiplier * float(cf->DireControl));
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Emerald, FString::Printf(TEXT("Capture Speed DIRE: %f"), cf->ControllingSpeed));
+		HealthWidget.SetValue(this->Health);
+		HealthWidget.SetPercent(this->Health / 100.0f);
 	}
-
-	else
-	{
-		CTFteam = "";
-
-	}
-
-	ControlFlagMulticast(cf, CTFteam);
-	//GetWorld()->GetTimerManager().SetTimer(cf->FlagTimer, this, &ABattleMobaCTF::TimerFunction, cf->ControllingSpeed, true, 0.0f);
-	//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Current CTF Team is %s"), ((*CTFteam.ToString()))));
 }
 
-bool ABattleMobaCharacter::ControlFlagMulticast_Validate(ABattleMobaCTF* cf, FName Team)
+bool ABattleMobaCharacter::MulticastExecuteAction_Validate(uint8 SkillId, uint8 SectionId, bool bSpecialAttack)
 {
 	return true;
 }
 
-void ABattleMobaCharacter::ControlFlagMulticast_Implementation(ABattleMobaCTF* cf, FName Team)
+void ABattleMobaCharacter::MulticastExecuteAction_Implementation(uint8 SkillId, uint8 SectionId, bool bSpecialAttack)
 {
-	if (Team == "Radiant")
-	{
-		//	Decrease the valDire if exists first before increasing valRadiant
-		if (cf->valDire <= 0.0f)
-		{
-			cf->valDire = 0.0f;
-
-			if (cf->valRadiant < 100.0f)
-			{
-				cf->valRadiant = cf->valRadiant + 1;
-				cf->isCompleted = false;
-			}
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_MulticastExecuteAction);
 
-			else
-			{
-				cf->valRadiant = 100.0f;
-				cf->ControllerTeam = "Radiant";
-				cf->isCompleted = true;	
-			}
-		}
-
-		else
-		{
-			cf->valDire = cf->valDire - 1;
-			cf->isCompleted = false;
-		}
-
-		cf->OnRep_Val();
-	}
-
-	else if (Team == "Dire")
+	/**		both sides resolve the skill and section against their own copy of ActionTable*/
+	const FActionSkill* SelectedRow = FindSkill(SkillId);
+	if (SelectedRow == nullptr)
 	{
-		if (cf->valRadiant <= 0.0f)
-		{
-			cf->valRadiant = 0.0f;
-
-			if (cf->valDire < 100.0f)
-			{
-				cf->valDire = cf->valDire + 1;
-				cf->isCompleted = false;
-			}
-			
-			else
-			{
-				cf->valDire = 100.0f;
-				cf->ControllerTeam = "Dire";
-				cf->isCompleted = true;
-			}
-		}
-
-		else
-		{
-			cf->valRadiant = cf->valRadiant - 1;
-			cf->isCompleted = false;
-		}
-
-		cf->OnRep_Val();
-	}
-}
-
-bool ABattleMobaCharacter::SetupStats_Validate()
-{
-	return true;
-}
-
-void ABattleMobaCharacter::SetupStats_Implementation()
-{
-	UUserWidget* HPWidget = Cast<UUserWidget>(W_DamageOutput->GetUserWidgetObject());
-	if (HPWidget)
-	{
-		//GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("Player %s with %s Widget"), *GetDebugName(this), *HPWidget->GetFName().ToString()));
-		const FName hptext = FName(TEXT("HealthText"));
-		UTextBlock* HealthText = (UTextBlock*)(HPWidget->WidgetTree->FindWidget(hptext));
-
-		const FName hpbar = FName(TEXT("HPBar"));
-		UProgressBar* HealthBar = (UProgressBar*)(HPWidget->WidgetTree->FindWidget(hpbar));
-
-		if (HealthText)
-		{
-			FString TheFloatStr = FString::SanitizeFloat(this->Health);
-
-			HealthText->SetText(FText::FromString(TheFloatStr));
-			HealthBar->SetPercent(FMath::Clamp(this->Health / 100.0f, 0.0f, 1.0f));
-		}
+		UE_LOG(LogTemp, Warning, TEXT("%s received unknown skill %d"), *GetName(), SkillId);
+		return;
 	}
-}
+	const FName MontageSection = GetSkillSectionName(SkillId, SectionId);
 
-bool ABattleMobaCharacter::MulticastExecuteAction_Validate(FActionSkill SelectedRow, FName MontageSection, bool bSpecialAttack)
-{
-	return true;
-}
-
-void ABattleMobaCharacter::MulticastExecuteAction_Implementation(FActionSkill SelectedRow, FName MontageSection, bool bSpecialAttack)
-{
 	/**		Checks SkeletalMesh exists / AnimInst Exists / Player is Stunned or still executing a skill */
 	if (this->GetMesh()->SkeletalMesh != nullptr)
 	{
 		if (this->AnimInsta != nullptr && this->IsStunned == false)
 		{
-			//GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("row->isOnCD: %s"), SelectedRow.isOnCD ? TEXT("true") : TEXT("false")));
-
 			/**		Disable movement on Action Skill*/
 			this->AnimInsta->CanMove = false;
 			this->OnSpecialAttack = bSpecialAttack;
@@ -1824,32 +1687,32 @@ void ABattleMobaCharacter::MulticastExecuteAction_Implementation(FActionSkill Se
 			if (bSpecialAttack == true)
 			{
 				//if current montage consumes cooldown properties
-				if (SelectedRow.IsUsingCD)
+				if (SelectedRow->IsUsingCD)
 				{
 					/**		set the counter moveset to skillmoveset*/
 					if (!this->CounterMoveset)
 					{
-						this->CounterMoveset = SelectedRow.SkillMoveset;
+						this->CounterMoveset = SelectedRow->SkillMoveset;
 					}
 
-					///GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Play montage: %s"), *SelectedRow.SkillMoveset->GetName()));
+					///GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Play montage: %s"), *SelectedRow->SkillMoveset->GetName()));
 					//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("ISUSINGCD")));
 
-					PlayAnimMontage(SelectedRow.SkillMoveset, 1.0f, MontageSection);
+					PlayAnimMontage(SelectedRow->SkillMoveset, 1.0f, MontageSection);
 				}
 			}
 
 			else
 			{
-				if (SelectedRow.UseTranslate)
+				if (SelectedRow->UseTranslate)
 				{
 					//FTimerHandle Delay;
 
-					if (SelectedRow.IsUsingCD)
+					if (SelectedRow->IsUsingCD)
 					{
-						//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Play montage: %s"), *SelectedRow.SkillMoveset->GetName()));
+						//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, FString::Printf(TEXT("Play montage: %s"), *SelectedRow->SkillMoveset->GetName()));
 
-						float montageTimer = this->GetMesh()->GetAnimInstance()->Montage_Play(SelectedRow.SkillMoveset, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
+						float montageTimer = this->GetMesh()->GetAnimInstance()->Montage_Play(SelectedRow->SkillMoveset, 1.0f, EMontagePlayReturnType::MontageLength, 0.0f, true);
 
 						////setting up for translate properties
 						//FTimerHandle handle;
@@ -1860,7 +1723,7 @@ void ABattleMobaCharacter::MulticastExecuteAction_Implementation(FActionSkill Se
 						//{
 						//	UE_LOG(LogTemp, Warning, TEXT("DELAY BEFORE TRANSLATE CHARACTER FORWARD"));
 
-						//	FVector dashVector = FVector(this->GetCapsuleComponent()->GetForwardVector().X*SelectedRow.TranslateDist, this->GetCapsuleComponent()->GetForwardVector().Y*SelectedRow.TranslateDist, this->GetCapsuleComponent()->GetForwardVector().Z);
+						//	FVector dashVector = FVector(this->GetCapsuleComponent()->GetForwardVector().X*SelectedRow->TranslateDist, this->GetCapsuleComponent()->GetForwardVector().Y*SelectedRow->TranslateDist, this->GetCapsuleComponent()->GetForwardVector().Z);
 
 						//	this->LaunchCharacter(dashVector, true, true);
 						//});
@@ -1872,25 +1735,10 @@ void ABattleMobaCharacter::MulticastExecuteAction_Implementation(FActionSkill Se
 					}
 				}
 
-				else if (SelectedRow.UseSection)
+				else if (SelectedRow->UseSection)
 				{
-					FTimerHandle delay;
-					FTimerDelegate timerDel;
-
-					this->OnComboDelay = true;
-
-					PlayAnimMontage(SelectedRow.SkillMoveset, 1.0f, MontageSection);
-
-					int32 sectionIndex = GetCurrentMontage()->GetSectionIndex(MontageSection);
-					float sectionLength = GetCurrentMontage()->GetSectionLength(sectionIndex);
-
-					timerDel.BindLambda([this]()
-					{
-						this->OnComboDelay = false;
-
-					});
-
-					this->GetWorldTimerManager().SetTimer(delay, timerDel, sectionLength + comboInterval, false);
+					//		the owner gates the next section itself, see AttackCombo
+					PlayAnimMontage(SelectedRow->SkillMoveset, 1.0f, MontageSection);
 				}
 
 				else
@@ -1900,164 +1748,120 @@ void ABattleMobaCharacter::MulticastExecuteAction_Implementation(FActionSkill Se
 
 			}
 
-			this->MinDamage = SelectedRow.MinDamage;
-			this->MaxDamage = SelectedRow.MaxDamage;
+			this->MinDamage = SelectedRow->MinDamage;
+			this->MaxDamage = SelectedRow->MaxDamage;
 			this->BaseDamage = float(FMath::RandRange(this->MinDamage, this->MaxDamage));
-			this->HitReactionMoveset = SelectedRow.HitMoveset;
-			this->FrontHitMoveset = SelectedRow.FrontHitMoveset;
-			this->BackHitMoveset = SelectedRow.BackHitMoveset;
-			this->LeftHitMoveset = SelectedRow.LeftHitMoveset;
-			this->RightHitMoveset = SelectedRow.RightHitMoveset;
-			this->HitEffect = SelectedRow.HitImpact;
+			this->HitReactionMoveset = SelectedRow->HitMoveset;
+			this->FrontHitMoveset = SelectedRow->FrontHitMoveset;
+			this->BackHitMoveset = SelectedRow->BackHitMoveset;
+			this->LeftHitMoveset = SelectedRow->LeftHitMoveset;
+			this->RightHitMoveset = SelectedRow->RightHitMoveset;
+			this->HitEffect = SelectedRow->HitImpact;
 		}	
 	}
 }
 
 
-bool ABattleMobaCharacter::AttackTrace_Validate(bool traceStart, int activeAttack)
+void ABattleMobaCharacter::AttackTrace(bool traceStart, int activeAttack)
 {
-	return true;
+	ServerAttackTrace(traceStart, activeAttack, GetServerTime());
 }
 
-void ABattleMobaCharacter::AttackTrace_Implementation(bool traceStart, int activeAttack)
+bool ABattleMobaCharacter::ServerAttackTrace_Validate(bool traceStart, int activeAttack, float ClientTime)
 {
-	//GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red, FString::Printf(TEXT("Start Tracing? %s"), traceStart ? TEXT("True") : TEXT("False")));
-
-	if (traceStart)
-	{
-		FHitResult hitResult;
-
-		FVector startTrace;
-		FVector endTrace;
-
-		TArray< TEnumAsByte<EObjectTypeQuery> > ObjectTypes;
-		ObjectTypes.Add(UEngineTypes::ConvertToObjectType(ECC_PhysicsBody));
-
-		TArray<class AActor*> IgnoreActors;
-		IgnoreActors.Add(this);
-
-		ActiveColliders.Empty();
-
-		if (activeAttack == 1)
-		{
-			ActiveColliders.Add(LPC1);
-			ActiveColliders.Add(LPC2);
-			ActiveColliders.Add(LPC3);
-			ActiveColliders.Add(LPC4);
-			ActiveColliders.Add(LPC5);
-			ActiveColliders.Add(LPC6);
-		}
+	return FMath::IsFinite(ClientTime);
+}
 
-		else if (activeAttack == 2)
-		{
-			ActiveColliders.Add(RPC1);
-			ActiveColliders.Add(RPC2);
-			ActiveColliders.Add(RPC3);
-			ActiveColliders.Add(RPC4);
-			ActiveColliders.Add(RPC5);
-			ActiveColliders.Add(RPC6);
-		}
+void ABattleMobaCharacter::ServerAttackTrace_Implementation(bool traceStart, int activeAttack, float ClientTime)
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ServerAttackTrace);
 
-		else if (activeAttack == 3)
-		{
-			ActiveColliders.Add(LKC1);
-			ActiveColliders.Add(LKC2);
-			ActiveColliders.Add(LKC3);
-			ActiveColliders.Add(LKC4);
-			ActiveColliders.Add(LKC5);
-			ActiveColliders.Add(LKC6);
-		}
+	MOBA_COMBAT_EVENT(AttackTrace, this, activeAttack, traceStart ? 1.0f : 0.0f);
 
-		else if (activeAttack == 4)
-		{
-			ActiveColliders.Add(RKC1);
-			ActiveColliders.Add(RKC2);
-			ActiveColliders.Add(RKC3);
-			ActiveColliders.Add(RKC4);
-			ActiveColliders.Add(RKC5);
-			ActiveColliders.Add(RKC6);
-		}
+	UMobaCombatTraceBatcher* Batcher = GetWorld()->GetSubsystem<UMobaCombatTraceBatcher>();
 
-		for (auto& attackCol : ActiveColliders)
+	if (traceStart)
+	{
+		/**		the slot is swept every frame until the trace ends, hits come back through ResolveAttackTrace*/
+		if (Batcher && Batcher->ArmAttack(this, activeAttack, FMobaLagCompensation::ClampRewindTime(GetWorld(), ClientTime)))
 		{
-			startTrace = attackCol->GetComponentLocation();
-			endTrace = startTrace + (GetActorForwardVector() * TraceDistance);
-
-			//bool bHit = GetWorld()->LineTraceSingleByObjectType(hitResult, startTrace, endTrace, FCollisionObjectQueryParams(ECC_TO_BITFIELD(ECC_Attack)), FCollisionQueryParams(TEXT("IKTrace"), false, this));
-			bool bHit = UKismetSystemLibrary::LineTraceSingleForObjects(GetWorld(), startTrace, endTrace, ObjectTypes, true, IgnoreActors, EDrawDebugTrace::ForDuration, hitResult, true, FColor::Red, FColor::Green, -1.0f);
-			
-			
-			if (bHit)
-			{
-				HitResult(hitResult);
-				GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, FString::Printf(TEXT("You are hitting: %s"), *hitResult.Actor->GetName()));
-
-			}
+			//		cleared when a new attack starts, the last sweep of the previous one may still be in flight
+			ArrDamagedEnemy.Empty();
 		}
 	}
 
-	else
+	else if (Batcher)
 	{
-		ArrDamagedEnemy.Empty();
+		Batcher->DisarmAttack(this);
 	}
 }
 
-bool ABattleMobaCharacter::HitResult_Validate(FHitResult hit)
+const TArray<FMobaHitboxVolume>* ABattleMobaCharacter::GetAttackSlotVolumes(int activeAttack) const
 {
-	return true;
+	return HitboxSet ? HitboxSet->GetSlotVolumes(activeAttack) : UMobaHitboxSet::GetDefaultSlotVolumes(activeAttack);
 }
 
-void ABattleMobaCharacter::HitResult_Implementation(FHitResult hit)
+void ABattleMobaCharacter::ResolveAttackTrace(EMobaCombatTraceKind Kind, int activeAttack, const TArray<FHitResult>& Hits)
 {
-	ABattleMobaCharacter* DamagedEnemy = Cast<ABattleMobaCharacter>(hit.Actor);
-	ADestructibleTower* DamagedTower = Cast<ADestructibleTower>(hit.Actor);
+	UCombatSubsystem* Combat = GetWorld()->GetSubsystem<UCombatSubsystem>();
+	if (Combat == nullptr)
+	{
+		return;
+	}
 
-	if (IsValid(DamagedEnemy))
+	if (Kind == EMobaCombatTraceKind::AttackTrace)
 	{
-		if (DamagedEnemy->TeamName != this->TeamName && (DamagedEnemy == hit.Actor) && !(ArrDamagedEnemy.Contains(DamagedEnemy)) && DamagedEnemy->InRagdoll == false)
+		for (const FHitResult& hitResult : Hits)
 		{
-			//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, FString::Printf(TEXT("You are hitting: %s"), *UKismetSystemLibrary::GetDisplayName(DamagedEnemy)));
-			if (DamagedEnemy->AnimInsta->Montage_IsPlaying(DamagedEnemy->CounterMoveset))
-			{
-				if (DamagedEnemy->IsLocallyControlled())
-				{
-					ServerRotateHitActor(DamagedEnemy, this);
-					ServerCounterAttack(DamagedEnemy);
-				}
-			}
-
-			else
-			{
-				/**		set the hitActor hit movesets from the same row of skill moveset the attacker used*/
-				DamagedEnemy->HitReactionMoveset = this->HitReactionMoveset;
-				DamagedEnemy->FrontHitMoveset = this->FrontHitMoveset;
-				DamagedEnemy->BackHitMoveset = this->BackHitMoveset;
-				DamagedEnemy->LeftHitMoveset = this->LeftHitMoveset;
-				DamagedEnemy->RightHitMoveset = this->RightHitMoveset;
-				ArrDamagedEnemy.Add(DamagedEnemy);
-				DoDamage(DamagedEnemy);
-			}
+			Combat->QueueHit(this, hitResult.GetActor(), Kind);
 		}
 	}
 
-	else if (IsValid(DamagedTower))
+	else
 	{
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Yellow, FString::Printf(TEXT("DamagedTower = %s"), IsValid(DamagedTower) ? TEXT("True") : TEXT("False")));
-		//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, FString::Printf(TEXT("You are hitting: %s"), *UKismetSystemLibrary::GetDisplayName(DamagedTower)));
-		if (DamagedTower->TeamName != this->TeamName && DamagedTower == hit.Actor && !(ArrDamagedEnemy.Contains(DamagedTower)) && DamagedTower->isDestroyed == false)
+		//		only the first valid enemy along the limb takes the hit
+		for (const FHitResult& hitRes : Hits)
 		{
-			ArrDamagedEnemy.Add(DamagedTower);
-			TowerReceiveDamage(DamagedTower, this->BaseDamage);
+			ABattleMobaCharacter* hitChar = Cast<ABattleMobaCharacter>(hitRes.Actor);
+
+			if (hitChar && hitChar->InRagdoll == false && hitChar->TeamName != this->TeamName)
+			{
+				Combat->QueueHit(this, hitChar, Kind);
+				break;
+			}
 		}
 	}
 }
 
-bool ABattleMobaCharacter::DoDamage_Validate(AActor* HitActor)
+bool ABattleMobaCharacter::IsCountering() const
 {
-	return true;
+	return this->AnimInsta && this->AnimInsta->Montage_IsPlaying(this->CounterMoveset);
+}
+
+void ABattleMobaCharacter::TriggerCounterAttack(ABattleMobaCharacter* Victim)
+{
+	ServerRotateHitActor(Victim, this);
+	ServerCounterAttack(Victim);
+}
+
+void ABattleMobaCharacter::CopyHitMovesets(const ABattleMobaCharacter* Attacker)
+{
+	this->HitReactionMoveset = Attacker->HitReactionMoveset;
+	this->FrontHitMoveset = Attacker->FrontHitMoveset;
+	this->BackHitMoveset = Attacker->BackHitMoveset;
+	this->LeftHitMoveset = Attacker->LeftHitMoveset;
+	this->RightHitMoveset = Attacker->RightHitMoveset;
 }
 
-void ABattleMobaCharacter::DoDamage_Implementation(AActor* HitActor)
+void ABattleMobaCharacter::SpawnHitEffect()
+{
+	if (this->HitEffect != nullptr && this->GetNetMode() != ENetMode::NM_DedicatedServer)
+	{
+		UMobaParticlePool::SpawnEmitter(GetWorld(), this->HitEffect, this->GetMesh()->GetSocketLocation(this->ActiveSocket), FRotator::ZeroRotator);
+	}
+}
+
+void ABattleMobaCharacter::DoDamage(AActor* HitActor)
 {
 	if (this != HitActor)
 	{
@@ -2066,140 +1870,41 @@ void ABattleMobaCharacter::DoDamage_Implementation(AActor* HitActor)
 		this->ActualDamage = FMath::RoundToInt(ActualDamage);
 
 		/**		Apply Damage */
-		//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Magenta, FString::Printf(TEXT("Damage Applied: %f"), this->ActualDamage));
-		UE_LOG(LogTemp, Warning, TEXT("Damage Applied: %f"), this->ActualDamage);
+		MOBA_COMBAT_EVENT(DamageApplied, this, 0, this->ActualDamage);
 		this->ActualDamage = UGameplayStatics::ApplyDamage(HitActor, this->ActualDamage, nullptr, this, nullptr);
 	}
 }
 
-bool ABattleMobaCharacter::FireTrace_Validate(UBoxComponent* Col1, UBoxComponent* Col2, UBoxComponent* Col3, UBoxComponent* Col4, UBoxComponent* Col5, UBoxComponent* Col6)
+void ABattleMobaCharacter::FireTrace(int activeAttack)
 {
-	return true;
+	ServerFireTrace(activeAttack, GetServerTime());
 }
 
-void ABattleMobaCharacter::FireTrace_Implementation(UBoxComponent* Col1, UBoxComponent* Col2, UBoxComponent* Col3, UBoxComponent* Col4, UBoxComponent* Col5, UBoxComponent* Col6)
+bool ABattleMobaCharacter::ServerFireTrace_Validate(int activeAttack, float ClientTime)
 {
+	return FMath::IsFinite(ClientTime);
+}
+
+void ABattleMobaCharacter::ServerFireTrace_Implementation(int activeAttack, float ClientTime)
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ServerFireTrace);
+
 	if (this->GetMesh()->SkeletalMesh != nullptr)
 	{
 		if (this->AnimInsta != nullptr)
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Magenta, FString::Printf(TEXT("Can Attack = %s"), AnimInsta->canAttack ? TEXT("True") : TEXT("False")));
+			MOBA_COMBAT_EVENT(FireTrace, this, activeAttack, AnimInsta->canAttack ? 1.0f : 0.0f, bApplyHitTrace ? 1.0f : 0.0f);
 			if (AnimInsta->canAttack == true)
 			{
-				GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Yellow, FString::Printf(TEXT("Apply Hit Trace = %s"), bApplyHitTrace ? TEXT("True") : TEXT("False")));
 				//		stop the hit happening again
 				if (bApplyHitTrace == true)
 				{
-					FHitResult hitRes1;
-					bool bHit1 = GetWorld()->LineTraceSingleByChannel(hitRes1, Col1->GetComponentLocation(), Col1->GetComponentLocation() + ( GetActorForwardVector() * TraceDistance), ECC_PhysicsBody, AttackTraceParams);
-
-					if (bHit1)
+					if (UMobaCombatTraceBatcher* Batcher = GetWorld()->GetSubsystem<UMobaCombatTraceBatcher>())
 					{
-						bApplyHitTrace = false;
-						//		pass hit results to further give conditions on damage
-						ABattleMobaCharacter* hitChar = Cast<ABattleMobaCharacter>(hitRes1.Actor);
-						ADestructibleTower* hitTower = Cast<ADestructibleTower>(hitRes1.Actor);
-
-						if (hitChar && hitChar->InRagdoll == false && hitChar->TeamName != this->TeamName)
-						{
-							DoDamage(hitChar);
-							bApplyHitTrace = true;
-						}
-					}
-
-					else
-					{
-						FHitResult hitRes2;
-						bool bHit2 = GetWorld()->LineTraceSingleByChannel(hitRes2, Col2->GetComponentLocation(), Col2->GetComponentLocation() + (GetActorForwardVector() * TraceDistance), ECC_PhysicsBody, AttackTraceParams);
-
-						if (bHit2)
-						{
-							bApplyHitTrace = false;
-							ABattleMobaCharacter* hitChar = Cast<ABattleMobaCharacter>(hitRes2.Actor);
-
-							if (hitChar && hitChar->InRagdoll == false && hitChar->TeamName != this->TeamName)
-							{
-								DoDamage(hitChar);
-								bApplyHitTrace = true;
-							}
-						}
-
-						else
-						{
-							FHitResult hitRes3;
-							bool bHit3 = GetWorld()->LineTraceSingleByChannel(hitRes3, Col3->GetComponentLocation(), Col3->GetComponentLocation() + (GetActorForwardVector() * TraceDistance), ECC_PhysicsBody, AttackTraceParams);
-
-							if (bHit3)
-							{
-								bApplyHitTrace = false;
-								ABattleMobaCharacter* hitChar = Cast<ABattleMobaCharacter>(hitRes3.Actor);
-
-								if (hitChar && hitChar->InRagdoll == false && hitChar->TeamName != this->TeamName)
-								{
-									DoDamage(hitChar);
-									bApplyHitTrace = true;
-								}
-							}
-
-							else
-							{
-								FHitResult hitRes4;
-								bool bHit4 = GetWorld()->LineTraceSingleByChannel(hitRes4, Col4->GetComponentLocation(), Col4->GetComponentLocation() + (GetActorForwardVector() * TraceDistance), ECC_PhysicsBody, AttackTraceParams);
-
-								if (bHit4)
-								{
-									bApplyHitTrace = false;
-									ABattleMobaCharacter* hitChar = Cast<ABattleMobaCharacter>(hitRes4.Actor);
-
-									if (hitChar && hitChar->InRagdoll == false && hitChar->TeamName != this->TeamName)
-									{
-										DoDamage(hitChar);
-										bApplyHitTrace = true;
-									}
-								}
-
-								else
-								{
-									FHitResult hitRes5;
-									bool bHit5 = GetWorld()->LineTraceSingleByChannel(hitRes5, Col5->GetComponentLocation(), Col5->GetComponentLocation() + (GetActorForwardVector() * TraceDistance), ECC_PhysicsBody, AttackTraceParams);
-
-									if (bHit5)
-									{
-										bApplyHitTrace = false;
-										ABattleMobaCharacter* hitChar = Cast<ABattleMobaCharacter>(hitRes5.Actor);
-
-										if (hitChar && hitChar->InRagdoll == false && hitChar->TeamName != this->TeamName)
-										{
-											DoDamage(hitChar);
-											bApplyHitTrace = true;
-										}
-									}
-
-									else
-									{
-										FHitResult hitRes6;
-										bool bHit6 = GetWorld()->LineTraceSingleByChannel(hitRes6, Col6->GetComponentLocation(), Col6->GetComponentLocation() + (GetActorForwardVector() * TraceDistance), ECC_PhysicsBody, AttackTraceParams);
-
-										if (bHit6)
-										{
-											bApplyHitTrace = false;
-											ABattleMobaCharacter* hitChar = Cast<ABattleMobaCharacter>(hitRes6.Actor);
-
-											if (hitChar && hitChar->InRagdoll == false && hitChar->TeamName != this->TeamName)
-											{
-												DoDamage(hitChar);
-												bApplyHitTrace = true;
-											}
-										}
-									}
-								}
-							}
-						}
+						Batcher->QueueAttack(this, EMobaCombatTraceKind::FireTrace, activeAttack, FMobaLagCompensation::ClampRewindTime(GetWorld(), ClientTime));
 					}
 				}
 			}
-
-			//		get AttackCol world locations
 		}
 	}
 }
@@ -2211,78 +1916,165 @@ bool ABattleMobaCharacter::ServerSetMaxWalkSpeed_Validate(float Val)
 
 void ABattleMobaCharacter::ServerSetMaxWalkSpeed_Implementation(float Val)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ServerSetMaxWalkSpeed);
+
 	GetCharacterMovement()->MaxWalkSpeed = Val;
 }
 
-bool ABattleMobaCharacter::ServerExecuteAction_Validate(FActionSkill SelectedRow, FName MontageSection, bool bSpecialAttack)
+bool ABattleMobaCharacter::ServerExecuteAction_Validate(uint8 SkillId, uint8 SectionId, bool bSpecialAttack)
 {
 	return true;
 }
 
-void ABattleMobaCharacter::ServerExecuteAction_Implementation(FActionSkill SelectedRow, FName MontageSection, bool bSpecialAttack)
+void ABattleMobaCharacter::ServerExecuteAction_Implementation(uint8 SkillId, uint8 SectionId, bool bSpecialAttack)
 {
-	MulticastExecuteAction(SelectedRow, MontageSection, bSpecialAttack);
-}
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ServerExecuteAction);
+
+	const FActionSkill* SelectedRow = FindSkill(SkillId);
+	if (SelectedRow == nullptr)
+	{
+		return;
+	}
 
+	//		translate skills skip DetectNearestTarget, their cooldown starts here
+	if (SelectedRow->IsUsingCD && SelectedRow->UseTranslate && !TryStartSkillCooldown(SkillId))
+	{
+		return;
+	}
 
+	MulticastExecuteAction(SkillId, SectionId, bSpecialAttack);
+}
 
-void ABattleMobaCharacter::TouchStarted(ETouchIndex::Type FingerIndex, FVector Location)
+float ABattleMobaCharacter::GetServerTime() const
 {
-	//Jump();
+	const AGameStateBase* GS = GetWorld()->GetGameState();
+	return GS ? GS->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
 }
 
-void ABattleMobaCharacter::TouchStopped(ETouchIndex::Type FingerIndex, FVector Location)
+bool ABattleMobaCharacter::IsSkillReady(int32 Index) const
 {
-	//StopJumping();
+	return !SkillReadyTimes.IsValidIndex(Index) || GetServerTime() >= SkillReadyTimes[Index];
 }
 
-void ABattleMobaCharacter::OnCameraShake()
+void ABattleMobaCharacter::StartSkillCooldown(int32 Index)
 {
-	CombatCamShake();
-	//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Orange, FString::Printf(TEXT("Calling Camera Shake Function")));
+	const FActionSkill* Skill = SkillIndex.GetSkill(Index);
+	if (Skill == nullptr || !Skill->IsUsingCD)
+	{
+		return;
+	}
+
+	if (SkillReadyTimes.Num() < SkillIndex.Num())
+	{
+		SkillReadyTimes.SetNumZeroed(SkillIndex.Num());
+	}
+	SkillReadyTimes[Index] = GetServerTime() + Skill->CDDuration;
 }
 
-void ABattleMobaCharacter::OnRep_Team()
+bool ABattleMobaCharacter::TryStartSkillCooldown(int32 Index)
 {
-	UUserWidget* HPWidget = Cast<UUserWidget>(W_DamageOutput->GetUserWidgetObject());
-	if (HPWidget)
+	if (FindSkill(Index) == nullptr)
 	{
-		const FName hptext = FName(TEXT("TeamName"));
-		UTextBlock* HealthText = (UTextBlock*)(HPWidget->WidgetTree->FindWidget(hptext));
+		return false;
+	}
 
-		if (HealthText)
-		{
-			HealthText->SetText(FText::FromName(TeamName));
-		}
+	//		the owner predicted the cooldown from its estimate of server time, allow for that
+	if (SkillReadyTimes.IsValidIndex(Index) && GetServerTime() + SkillCooldownTolerance < SkillReadyTimes[Index])
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s used %s while on cooldown"), *GetName(), *SkillIndex.GetRowName(Index).ToString());
+		return false;
 	}
+
+	StartSkillCooldown(Index);
+	return true;
 }
 
-bool ABattleMobaCharacter::TowerReceiveDamage_Validate(ADestructibleTower * Tower, float DamageApply)
+uint8 ABattleMobaCharacter::GetSkillSectionId(int32 SkillId, FName Section)
 {
-	return true;
+	const FActionSkill* Skill = FindSkill(SkillId);
+	const int32 SectionIndex = (Skill && Skill->SkillMoveset) ? Skill->SkillMoveset->GetSectionIndex(Section) : INDEX_NONE;
+
+	return (SectionIndex >= 0 && SectionIndex < NoSkillSection) ? uint8(SectionIndex) : NoSkillSection;
 }
 
-void ABattleMobaCharacter::TowerReceiveDamage_Implementation(ADestructibleTower * Tower, float DamageApply)
+FName ABattleMobaCharacter::GetSkillSectionName(int32 SkillId, uint8 SectionId)
 {
-	if (Tower)
+	const FActionSkill* Skill = FindSkill(SkillId);
+
+	return (Skill && Skill->SkillMoveset && SectionId != NoSkillSection) ? Skill->SkillMoveset->GetSectionName(SectionId) : NAME_None;
+}
+
+const FActionSkill* ABattleMobaCharacter::FindSkill(int32 SkillId)
+{
+	//		ActionTable may be a blueprint default that never replicates
+	if (!SkillIndex.IsBuiltFor(ActionTable))
 	{
-		//ABattleMobaCharacter* Player = Cast<ABattleMobaCharacter>(HitActor);
-		Tower->CurrentHealth = FMath::Clamp(Tower->CurrentHealth - DamageApply, 0.0f, Tower->MaxHealth);
-		Tower->IsHit = false;
-		Tower->OnRep_UpdateHealth();
+		BuildSkillIndex();
+	}
+	return SkillIndex.GetSkill(SkillId);
+}
 
-		if (Tower->CurrentHealth <= 0.0f)
-		{
-			//Tower->CurrentHealth = 0.0f;
-			Tower->isDestroyed = true;
+void ABattleMobaCharacter::OnRep_ActionTable()
+{
+	BuildSkillIndex();
+}
 
+void ABattleMobaCharacter::BuildSkillIndex()
+{
+	SkillIndex.Build(ActionTable);
 
-			/**		Destroy Tower*/
-			//Tower->SetActorHiddenInGame(true);
-			Tower->OnRep_Destroy();
-		}
+	//		hit impacts of the new skills are ready before the first hit lands
+	if (UMobaParticlePool* Pool = GetWorld() ? GetWorld()->GetSubsystem<UMobaParticlePool>() : nullptr)
+	{
+		Pool->PrewarmSkills(SkillIndex);
+	}
+}
+
+void ABattleMobaCharacter::ResetSkillCooldowns()
+{
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		SkillReadyTimes.Init(0.0f, SkillIndex.Num());
+	}
+}
+
+float ABattleMobaCharacter::GetSkillCooldownRemaining(FKey Key, FString ButtonName) const
+{
+	const int32 Index = SkillIndex.Find(Key, ButtonName);
+	return SkillReadyTimes.IsValidIndex(Index) ? FMath::Max(SkillReadyTimes[Index] - GetServerTime(), 0.0f) : 0.0f;
+}
+
+
+
+void ABattleMobaCharacter::TouchStarted(ETouchIndex::Type FingerIndex, FVector Location)
+{
+	//Jump();
+}
+
+void ABattleMobaCharacter::TouchStopped(ETouchIndex::Type FingerIndex, FVector Location)
+{
+	//StopJumping();
+}
+
+void ABattleMobaCharacter::OnCameraShake()
+{
+	CombatCamShake();
+	//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Orange, FString::Printf(TEXT("Calling Camera Shake Function")));
+}
+
+void ABattleMobaCharacter::OnRep_Team()
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetUpdate);
+
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->SetTeam(this, TeamName);
+	}
+
+	if (HealthWidget.Bind(W_DamageOutput))
+	{
+		HealthWidget.SetTeam(TeamName);
 	}
-	
 }
 
 void ABattleMobaCharacter::TurnAtRate(float Rate)
@@ -2361,8 +2153,26 @@ void ABattleMobaCharacter::MoveRight(float Value)
 	}
 }
 
+bool ABattleMobaCharacter::ServerChooseBattleStyle_Validate(int style)
+{
+	return style >= 1 && style <= 3;
+}
+
+void ABattleMobaCharacter::ServerChooseBattleStyle_Implementation(int style)
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ServerChooseBattleStyle);
+
+	ChooseBattleStyle(style);
+}
+
 void ABattleMobaCharacter::ChooseBattleStyle(int style)
 {
+	//		skill RPCs only carry indices into ActionTable, so the server has to use the same table
+	if (GetLocalRole() == ROLE_AutonomousProxy)
+	{
+		ServerChooseBattleStyle(style);
+	}
+
 	//		silat moveset
 	if (style == 1)
 	{		
@@ -2393,4 +2203,7 @@ void ABattleMobaCharacter::ChooseBattleStyle(int style)
 		this->MaxHealth = 1100.0f;
 		this->Defence = 180.0f;
 	}
+
+	BuildSkillIndex();
+	ResetSkillCooldowns();
 }
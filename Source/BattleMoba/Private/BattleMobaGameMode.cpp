@@ -17,6 +17,10 @@
 #include "BattleMobaPC.h"
 #include "InputLibrary.h"
 #include "Net/UnrealNetwork.h"
+#include "MobaNetAccounting.h"
+#include "BattleMoba.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_RespawnRequested, "RPC RespawnRequested");
 
 ABattleMobaGameMode::ABattleMobaGameMode()
 {
@@ -141,6 +145,11 @@ void ABattleMobaGameMode::StartClock()
 			}
 			else
 				GState->Winner = "Draw";
+
+			if (UMobaNetAccounting* Accounting = UMobaNetAccounting::Get(this))
+			{
+				Accounting->WriteReport();
+			}
 		}
 	}
 	
@@ -159,6 +168,7 @@ void ABattleMobaGameMode::SpawnBasedOnTeam/*_Implementation*/(FName TeamName, US
 		if (HasAuthority())
 		{
 			PS->TeamName = TeamName;
+			PS->OnRep_TeamName();
 			PS->CharMesh = CharMesh;
 
 			AActor* PStart = FindPlayerStart(newPlayer, FString::FromInt(PS->Pi));
@@ -273,16 +283,36 @@ bool ABattleMobaGameMode::RespawnRequested_Validate(APlayerController* playerCon
 
 void ABattleMobaGameMode::RespawnRequested_Implementation(APlayerController* playerController, FTransform SpawnTransform)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_RespawnRequested);
+
 	if (playerController != nullptr)
 	{
 		if (HasAuthority())
 		{
+			ABattleMobaPlayerState* PS = Cast<ABattleMobaPlayerState>(playerController->PlayerState);
+
+			//		reuse the pawn parked when this player was knocked out
+			if (ABattleMobaCharacter* pooled = TakePooledPawn(playerController, PS ? PS->CharMesh : nullptr))
+			{
+				if (playerController->GetPawn() != nullptr)
+				{
+					playerController->GetPawn()->Destroy();
+				}
+
+				pooled->ResetForRespawn(SpawnTransform);
+
+				playerController->Possess(pooled);
+				playerController->ClientSetRotation(pooled->GetActorRotation());
+				playerController->bShowMouseCursor = false;
+				playerController->SetInputMode(FInputModeGameOnly());
+				return;
+			}
+
 			//destroys existing pawn before spawning a new one
 			if (playerController->GetPawn() != nullptr)
 			{
 				playerController->GetPawn()->Destroy();
 			}
-			ABattleMobaPlayerState* PS = Cast<ABattleMobaPlayerState>(playerController->PlayerState);
 			{
 				//Spawn actor
 				if (SpawnedActor)
@@ -309,3 +339,111 @@ void ABattleMobaGameMode::RespawnRequested_Implementation(APlayerController* pla
 		}
 	}
 }
+
+void ABattleMobaGameMode::Logout(AController* Exiting)
+{
+	ABattleMobaCharacter* pooled = nullptr;
+	if (PooledPawns.RemoveAndCopyValue(Exiting, pooled) && pooled != nullptr)
+	{
+		pooled->Destroy();
+	}
+
+	Super::Logout(Exiting);
+}
+
+void ABattleMobaGameMode::ParkPawn(AController* Controller)
+{
+	ABattleMobaCharacter* pawn = Controller ? Cast<ABattleMobaCharacter>(Controller->GetPawn()) : nullptr;
+	if (pawn == nullptr)
+	{
+		if (Controller && Controller->GetPawn())
+		{
+			Controller->GetPawn()->Destroy();
+		}
+		return;
+	}
+
+	Controller->UnPossess();
+	pawn->ParkForPool();
+
+	//		one pawn per player, an older one is never coming back
+	ABattleMobaCharacter* previous = nullptr;
+	if (PooledPawns.RemoveAndCopyValue(Controller, previous) && previous != nullptr && previous != pawn)
+	{
+		previous->Destroy();
+	}
+	PooledPawns.Add(Controller, pawn);
+}
+
+ABattleMobaCharacter* ABattleMobaGameMode::TakePooledPawn(AController* Controller, USkeletalMesh* CharMesh)
+{
+	ABattleMobaCharacter* pooled = nullptr;
+	if (!PooledPawns.RemoveAndCopyValue(Controller, pooled) || pooled == nullptr || pooled->IsPendingKill())
+	{
+		return nullptr;
+	}
+
+	//		the player picked another character, the old pawn cannot be reused
+	if (pooled->GetClass() != SpawnedActor || pooled->CharMesh != CharMesh)
+	{
+		pooled->Destroy();
+		return nullptr;
+	}
+	return pooled;
+}
+
+void ABattleMobaGameMode::MobaBenchRespawn(int32 Iterations)
+{
+	ABattleMobaCharacter* pawn = nullptr;
+	for (ABattleMobaPC* PC : Players)
+	{
+		pawn = PC ? Cast<ABattleMobaCharacter>(PC->GetPawn()) : nullptr;
+		if (pawn)
+		{
+			break;
+		}
+	}
+
+	if (pawn == nullptr || !SpawnedActor || Iterations <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MobaBenchRespawn: needs a possessed character and SpawnedActor"));
+		return;
+	}
+
+	const FTransform SpawnTransform = pawn->GetActorTransform();
+
+	//		fresh pawns, what every respawn used to cost
+	double Start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; ++i)
+	{
+		ABattleMobaCharacter* fresh = GetWorld()->SpawnActorDeferred<ABattleMobaCharacter>(SpawnedActor, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (fresh)
+		{
+			fresh->TeamName = pawn->TeamName;
+			fresh->CharMesh = pawn->CharMesh;
+			UGameplayStatics::FinishSpawningActor(fresh, SpawnTransform);
+			fresh->Destroy();
+		}
+	}
+	const double FreshSeconds = FPlatformTime::Seconds() - Start;
+
+	//		pooled pawn parked and brought back in place
+	AController* controller = pawn->GetController();
+	controller->UnPossess();
+
+	Start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; ++i)
+	{
+		pawn->ParkForPool();
+		pawn->ResetForRespawn(SpawnTransform);
+	}
+	const double PooledSeconds = FPlatformTime::Seconds() - Start;
+
+	controller->Possess(pawn);
+
+	const FString Summary = FString::Printf(TEXT("Respawn x%d: spawn %.3f ms each, pooled reset %.3f ms each (%.1fx)"),
+		Iterations, FreshSeconds * 1000.0 / Iterations, PooledSeconds * 1000.0 / Iterations, PooledSeconds > 0.0 ? FreshSeconds / PooledSeconds : 0.0);
+
+	UE_LOG(LogTemp, Display, TEXT("%s"), *Summary);
+	GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Cyan, Summary);
+}
@@ -11,6 +11,8 @@
 #include "Components/TextBlock.h"
 #include "Components/ProgressBar.h"
 #include "Components/WidgetComponent.h"
+#include "MobaNetAccounting.h"
+#include "BattleMoba.h"
 
 void ABattleMobaGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
@@ -25,57 +27,46 @@ void ABattleMobaGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 	DOREPLIFETIME(ABattleMobaGameState, Winner);
 }
 
+bool ABattleMobaGameState::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	UMobaNetAccounting::RecordRpcFor(this, Function, Parameters);
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void ABattleMobaGameState::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+	UMobaNetAccounting::RecordPropertiesFor(this);
+}
+
 void ABattleMobaGameState::SetTowerWidgetColors(ABattleMobaCTF* cf)
 {
-	if (cf->ActivePlayer != nullptr)
-	{
-		//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Cyan, FString::Printf(TEXT("Actor tName %s"), ((*cf->ActivePlayer->GetFName().ToString()))));
-		UUserWidget* HPWidget = Cast<UUserWidget>(cf->W_ValControl->GetUserWidgetObject());
-		if (HPWidget)
-		{
-			const FName hptext = FName(TEXT("ValText"));
-			UTextBlock* HealthText = (UTextBlock*)(HPWidget->WidgetTree->FindWidget(hptext));
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetUpdate);
 
-			const FName hpbar = FName(TEXT("PBar"));
-			UProgressBar* PBar = (UProgressBar*)(HPWidget->WidgetTree->FindWidget(hpbar));
+	FMobaWidgetBinding& FlagWidget = cf->ValueWidget;
+	if (cf->ActivePlayer != nullptr && FlagWidget.Bind(cf->W_ValControl) && FlagWidget.GetPercent() <= 0.0f)
+	{
+		//get playerstate from local player controller
+		APlayerController* LocalPC = UGameplayStatics::GetPlayerController(GetWorld(), 0);
+		ABattleMobaPlayerState* thisPS = LocalPC ? Cast<ABattleMobaPlayerState>(LocalPC->PlayerState) : nullptr;
 
-			if (PBar->Percent <= 0.0f)
-			{
-				//get playerstate from local player controller
-				ABattleMobaPlayerState* thisPS = Cast<ABattleMobaPlayerState>(UGameplayStatics::GetPlayerController(GetWorld(), 0)->PlayerState);
+		//get playerstate from current tower owner
+		ABattleMobaPlayerState* activePS = Cast<ABattleMobaPlayerState>(cf->ActivePlayer->GetPlayerState());
 
-				//get playerstate from current tower owner
-				ABattleMobaPlayerState* activePS = Cast<ABattleMobaPlayerState>(cf->ActivePlayer->GetPlayerState());
+		if (thisPS == nullptr || activePS == nullptr)
+		{
+			return;
+		}
 
-				//if current controller is current active player that owned tower
-				if (thisPS == activePS)
-				{
-					//Change progressbar color to blue
-					PBar->SetFillColorAndOpacity(FLinearColor(0.5f, 1.0f, 0.0f));
-					if (HealthText)
-					{
-						HealthText->SetColorAndOpacity(FLinearColor(0.5f, 1.0f, 0.0f));
-					}				
-				}
-				else if (thisPS->TeamName == activePS->TeamName)//if current owner is on the same team as current local player
-				{
-					PBar->SetFillColorAndOpacity(FLinearColor(0.5f, 1.0f, 0.0f));
-					if (HealthText)
-					{
-						HealthText->SetColorAndOpacity(FLinearColor(0.5f, 1.0f, 0.0f));
-					}
-				}
-				else //if its an enemy, change tower to red locally
-				{
-					PBar->SetFillColorAndOpacity(FLinearColor(1.0f, 0.0f, 0.0f));
-					if (HealthText)
-					{
-						HealthText->SetColorAndOpacity(FLinearColor(1.0f, 0.0f, 0.0f));
-					}
-				}
-			}
+		//if current controller owns the tower or is on the same team as its owner
+		if (thisPS == activePS || thisPS->TeamName == activePS->TeamName)
+		{
+			FlagWidget.SetColor(FLinearColor(0.5f, 1.0f, 0.0f));
+		}
+		else //if its an enemy, change tower to red locally
+		{
+			FlagWidget.SetColor(FLinearColor(1.0f, 0.0f, 0.0f));
 		}
-		//GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Red, FString::Printf(TEXT("Actor is invalid")));
 	}
 }
 
@@ -12,6 +12,12 @@
 #include "BattleMobaGameMode.h"
 #include "BattleMobaPlayerState.h"
 #include "BattleMobaGameState.h"
+#include "BattleMoba.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_ClientCosmeticEvents, "RPC ClientCosmeticEvents");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_SpectateNextPlayer, "RPC SpectateNextPlayer");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_SetupSpectator, "RPC SetupSpectator");
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_RespawnPawn, "RPC RespawnPawn");
 
 ABattleMobaPC::ABattleMobaPC()
 {
@@ -30,6 +36,13 @@ void ABattleMobaPC::BeginPlay()
 	Super::BeginPlay();
 }
 
+void ABattleMobaPC::ClientCosmeticEvents_Implementation(const FMobaCosmeticBatch& Batch)
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_ClientCosmeticEvents);
+
+	Batch.Apply();
+}
+
 int32 ABattleMobaPC::CheckIndexValidity(int32 index, TArray<ABattleMobaPC*> PlayerList, EFormula SwitchMode)
 {
 	if (SwitchMode == EFormula::Addition)
@@ -65,6 +78,8 @@ bool ABattleMobaPC::SpectateNextPlayer_Validate(const TArray<ABattleMobaPC*>& Pl
 
 void ABattleMobaPC::SpectateNextPlayer_Implementation(const TArray<ABattleMobaPC*>& PlayerList, EFormula SwitchMode)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_SpectateNextPlayer);
+
 
 	bool x = false;
 	int32 count = 0;
@@ -121,6 +136,8 @@ bool ABattleMobaPC::SetupSpectator_Validate(EFormula SwitchMode)
 
 void ABattleMobaPC::SetupSpectator_Implementation(EFormula SwitchMode)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_SetupSpectator);
+
 	if (this->GetPawn() == nullptr) // make sure no owning pawn present before spectating
 	{
 		GM = Cast<ABattleMobaGameMode>(UGameplayStatics::GetGameMode(this));
@@ -138,14 +155,13 @@ bool ABattleMobaPC::RespawnPawn_Validate(FTransform SpawnTransform)
 
 void ABattleMobaPC::RespawnPawn_Implementation(FTransform SpawnTransform)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_RespawnPawn);
+
 	ABattleMobaGameMode* thisGameMode = Cast<ABattleMobaGameMode>(UGameplayStatics::GetGameMode(this));
 	if (thisGameMode)
 	{
-		//Destroy pawn before respawning
-		if (this->GetPawn())
-		{
-			this->GetPawn()->Destroy();
-		}
+		//Park the pawn so the respawn can reuse it
+		thisGameMode->ParkPawn(this);
 
 		FTimerHandle handle;
 		FTimerDelegate TimerDelegate;
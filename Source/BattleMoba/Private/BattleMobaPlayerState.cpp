@@ -5,6 +5,12 @@
 #include "Engine.h"
 #include "Net/UnrealNetwork.h"
 
+#include "MobaWorldRegistry.h"
+#include "MobaNetAccounting.h"
+#include "BattleMoba.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaRpc_SetPlayerIndex, "RPC SetPlayerIndex");
+
 void ABattleMobaPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -21,6 +27,46 @@ void ABattleMobaPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
 	DOREPLIFETIME(ABattleMobaPlayerState, MaxHealth);
 }
 
+bool ABattleMobaPlayerState::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	UMobaNetAccounting::RecordRpcFor(this, Function, Parameters);
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void ABattleMobaPlayerState::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+	UMobaNetAccounting::RecordPropertiesFor(this);
+}
+
+void ABattleMobaPlayerState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Register(this, TeamName);
+	}
+}
+
+void ABattleMobaPlayerState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ABattleMobaPlayerState::OnRep_TeamName()
+{
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->SetTeam(this, TeamName);
+	}
+}
+
 bool ABattleMobaPlayerState::SetPlayerIndex_Validate(int32 PlayerIndex)
 {
 	return true;
@@ -28,6 +74,8 @@ bool ABattleMobaPlayerState::SetPlayerIndex_Validate(int32 PlayerIndex)
 
 void ABattleMobaPlayerState::SetPlayerIndex_Implementation(int32 PlayerIndex)
 {
+	MOBA_SCOPE_CYCLE(STAT_MobaRpc_SetPlayerIndex);
+
 	this->Pi = PlayerIndex;
 	GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Orange, FString::Printf(TEXT("PlayerIndex : %f"), this->Pi));
 }
@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CombatSubsystem.h"
+#include "Engine/World.h"
+#include "Animation/AnimInstance.h"
+
+#include "BattleMoba.h"
+#include "BattleMobaCharacter.h"
+#include "BattleMobaAnimInstance.h"
+#include "DestructibleTower.h"
+#include "MobaCombatLog.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaCombatResolve, "Combat Resolve");
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Hits Queued"), STAT_MobaCombatHitsQueued, STATGROUP_BattleMoba);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Net Updates"), STAT_MobaCombatNetUpdates, STATGROUP_BattleMoba);
+
+FMobaHitReaction& FMobaHitReactionArray::Push()
+{
+	//		sequence 0 is what a client that never saw a hit starts from
+	if (++NextSequence == 0)
+	{
+		++NextSequence;
+	}
+
+	FMobaHitReaction* Reaction = nullptr;
+	if (Items.Num() < Capacity)
+	{
+		Reaction = &Items.AddDefaulted_GetRef();
+	}
+	else
+	{
+		Reaction = &Items[OldestIndex];
+		//		keep the replication id so the client sees a change rather than a remove and add
+		Reaction->Attacker = nullptr;
+		Reaction->Direction = EMobaHitDirection::Special;
+		Reaction->SectionId = 0;
+		Reaction->bKnockout = false;
+		OldestIndex = (OldestIndex + 1) % Capacity;
+	}
+
+	Reaction->Sequence = NextSequence;
+	return *Reaction;
+}
+
+const FMobaHitReaction* FMobaHitReactionArray::GetLatest() const
+{
+	const FMobaHitReaction* Latest = nullptr;
+	for (const FMobaHitReaction& Reaction : Items)
+	{
+		if (Latest == nullptr || IsNewer(Reaction.Sequence, Latest->Sequence))
+		{
+			Latest = &Reaction;
+		}
+	}
+	return Latest;
+}
+
+void FMobaHitReactionArray::Reset()
+{
+	Items.Reset();
+	OldestIndex = 0;
+	MarkArrayDirty();
+}
+
+void UCombatSubsystem::QueueHit(ABattleMobaCharacter* Attacker, AActor* Target, EMobaCombatTraceKind Kind)
+{
+	if (Attacker == nullptr || Target == nullptr || Attacker == Target)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MobaCombatHitsQueued);
+
+	FCombatHitEvent& Event = PendingHits.AddDefaulted_GetRef();
+	Event.Attacker = Attacker;
+	Event.Target = Target;
+	Event.Kind = Kind;
+}
+
+void UCombatSubsystem::MarkDirty(AActor* Actor)
+{
+	DirtyActors.AddUnique(Actor);
+}
+
+void UCombatSubsystem::Deinitialize()
+{
+	PendingHits.Empty();
+	DirtyActors.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCombatSubsystem::Tick(float DeltaTime)
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaCombatResolve);
+
+	/**		hits queued while resolving (none today) wait for the next frame*/
+	TArray<FCombatHitEvent> Hits = MoveTemp(PendingHits);
+	PendingHits.Reset();
+
+	for (const FCombatHitEvent& Event : Hits)
+	{
+		ABattleMobaCharacter* Attacker = Event.Attacker.Get();
+		AActor* Target = Event.Target.Get();
+		if (Attacker == nullptr || Target == nullptr)
+		{
+			continue;
+		}
+
+		if (ABattleMobaCharacter* Victim = Cast<ABattleMobaCharacter>(Target))
+		{
+			ResolveCharacterHit(Attacker, Victim, Event.Kind);
+		}
+		else if (ADestructibleTower* Tower = Cast<ADestructibleTower>(Target))
+		{
+			ResolveTowerHit(Attacker, Tower);
+		}
+	}
+
+	//		one net update per touched actor, property replication takes care of relevancy
+	for (const TWeakObjectPtr<AActor>& Actor : DirtyActors)
+	{
+		if (Actor.IsValid())
+		{
+			Actor->ForceNetUpdate();
+			INC_DWORD_STAT(STAT_MobaCombatNetUpdates);
+		}
+	}
+	DirtyActors.Reset();
+}
+
+void UCombatSubsystem::ResolveCharacterHit(ABattleMobaCharacter* Attacker, ABattleMobaCharacter* Victim, EMobaCombatTraceKind Kind)
+{
+	if (Victim->TeamName == Attacker->TeamName || Victim->IsInRagdoll())
+	{
+		return;
+	}
+
+	//		skill traces hit once per trace, the batcher already picked the first enemy
+	if (Kind == EMobaCombatTraceKind::FireTrace)
+	{
+		Attacker->DoDamage(Victim);
+		MOBA_COMBAT_EVENT(HitResolved, Victim, int32(Kind), Victim->GetHealth());
+		return;
+	}
+
+	if (Attacker->HasDamaged(Victim))
+	{
+		return;
+	}
+
+	if (Victim->IsCountering())
+	{
+		if (Victim->IsLocallyControlled())
+		{
+			Attacker->TriggerCounterAttack(Victim);
+		}
+		return;
+	}
+
+	/**		set the hitActor hit movesets from the same row of skill moveset the attacker used*/
+	Victim->CopyHitMovesets(Attacker);
+	Attacker->AddDamaged(Victim);
+	Attacker->DoDamage(Victim);
+	MOBA_COMBAT_EVENT(HitResolved, Victim, int32(Kind), Victim->GetHealth());
+}
+
+void UCombatSubsystem::ResolveTowerHit(ABattleMobaCharacter* Attacker, ADestructibleTower* Tower)
+{
+	if (Tower->TeamName == Attacker->TeamName || Tower->isDestroyed == true || Attacker->HasDamaged(Tower))
+	{
+		return;
+	}
+
+	Attacker->AddDamaged(Tower);
+
+	Tower->CurrentHealth = FMath::Clamp(Tower->CurrentHealth - Attacker->GetBaseDamage(), 0.0f, Tower->MaxHealth);
+	Tower->IsHit = false;
+	Tower->OnRep_UpdateHealth();
+
+	if (Tower->CurrentHealth <= 0.0f)
+	{
+		/**		Destroy Tower*/
+		Tower->isDestroyed = true;
+		Tower->OnRep_Destroy();
+	}
+
+	MarkDirty(Tower);
+}
+
+bool UCombatSubsystem::IsTickable() const
+{
+	return !IsTemplate() && PendingHits.Num() > 0;
+}
+
+ETickableTickType UCombatSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UCombatSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatSubsystem, STATGROUP_Tickables);
+}
@@ -13,6 +13,10 @@
 #include "BattleMobaGameState.h"
 #include "BattleMobaGameMode.h"
 #include "BattleMobaPlayerState.h"
+#include "MobaWorldRegistry.h"
+#include "MobaWidgetManager.h"
+#include "MobaNetAccounting.h"
+#include "BattleMoba.h"
 
 void ADestructibleTower::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
@@ -24,6 +28,18 @@ void ADestructibleTower::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& O
 	DOREPLIFETIME(ADestructibleTower, isDestroyed);
 }
 
+bool ADestructibleTower::CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack)
+{
+	UMobaNetAccounting::RecordRpcFor(this, Function, Parameters);
+	return Super::CallRemoteFunction(Function, Parameters, OutParms, Stack);
+}
+
+void ADestructibleTower::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+	UMobaNetAccounting::RecordPropertiesFor(this);
+}
+
 // Sets default values
 ADestructibleTower::ADestructibleTower()
 {
@@ -63,22 +79,17 @@ ADestructibleTower::ADestructibleTower()
 	W_Health->SetDrawAtDesiredSize(true);
 	W_Health->SetGenerateOverlapEvents(false);
 
+	HealthWidget = FMobaWidgetBinding(TEXT("HealthText"), NAME_None, TEXT("TeamName"));
+
 }
 
 void ADestructibleTower::OnRep_UpdateHealth()
 {
-	if (W_DisplayHealth)
-	{
-		//GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Blue, FString::Printf(TEXT("Player %s with %s Widget"), *GetDebugName(this), *W_DisplayHealth->GetFName().ToString()));
-		const FName hptext = FName(TEXT("HealthText"));
-		UTextBlock* HealthText = (UTextBlock*)(W_DisplayHealth->WidgetTree->FindWidget(hptext));
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetUpdate);
 
-		if (HealthText)
-		{
-			FString TheFloatStr = FString::SanitizeFloat(this->CurrentHealth);
-
-			HealthText->SetText(FText::FromString(TheFloatStr));
-		}
+	if (HealthWidget.Bind(W_DisplayHealth))
+	{
+		HealthWidget.SetValue(this->CurrentHealth);
 	}
 }
 
@@ -103,6 +114,11 @@ void ADestructibleTower::OnRep_Destroy()
 		{
 			GameState->Winner = "Radiant Wins";
 		}
+
+		if (UMobaNetAccounting* Accounting = UMobaNetAccounting::Get(this))
+		{
+			Accounting->WriteReport();
+		}
 	}
 	
 	
@@ -119,16 +135,32 @@ void ADestructibleTower::OnRep_Destroy()
 
 void ADestructibleTower::OnRep_Team()
 {
-	if (W_DisplayHealth)
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetUpdate);
+
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->SetTeam(this, TeamName);
+	}
+
+	if (HealthWidget.Bind(W_DisplayHealth))
+	{
+		HealthWidget.SetTeam(TeamName);
+	}
+}
+
+void ADestructibleTower::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
 	{
-		const FName hptext = FName(TEXT("TeamName"));
-		UTextBlock* HealthText = (UTextBlock*)(W_DisplayHealth->WidgetTree->FindWidget(hptext));
+		Registry->Unregister(this);
+	}
 
-		if (HealthText)
-		{
-			HealthText->SetText(FText::FromName(TeamName));
-		}
+	if (UMobaWidgetManager* WidgetManager = GetWorld()->GetSubsystem<UMobaWidgetManager>())
+	{
+		WidgetManager->UnregisterWidget(W_Health);
 	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called when the game starts or when spawned
@@ -140,9 +172,18 @@ void ADestructibleTower::BeginPlay()
 
 	W_DisplayHealth = Cast<UUserWidget>(W_Health->GetUserWidgetObject());
 
-	GameState = Cast<ABattleMobaGameState>(UGameplayStatics::GetGameState(this));
+	if (UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(this))
+	{
+		Registry->Register(this, TeamName);
+
+		GameState = Registry->GetGameState();
+		GameMode = Registry->GetGameMode();
+	}
 
-	GameMode = Cast<ABattleMobaGameMode>(UGameplayStatics::GetGameMode(this));
+	if (UMobaWidgetManager* WidgetManager = GetWorld()->GetSubsystem<UMobaWidgetManager>())
+	{
+		WidgetManager->RegisterWidget(W_Health);
+	}
 
 	if (GameState)
 	{
@@ -0,0 +1,405 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaCombatBenchCommandlet.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameMapsSettings.h"
+#include "HAL/MallocBase.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Tickable.h"
+
+#include "BattleMobaCharacter.h"
+#include "BattleMobaGameMode.h"
+#include "BattleMobaPlayerState.h"
+#include "InputLibrary.h"
+#include "MobaCombatTraceBatcher.h"
+#include "MobaWorldRegistry.h"
+
+//Characters swing once they are this close to their target
+static const float BenchAttackRange = 120.0f;
+
+//How long an attack slot stays armed, about the length of a hit window in the movesets
+static const float BenchSwingSeconds = 0.3f;
+
+//Knocked out characters come back after the same delay as RespawnCharacter
+static const float BenchRespawnSeconds = 3.0f;
+
+//Distance between the two teams' spawn lines
+static const float BenchArenaWidth = 2000.0f;
+
+/**		Counts allocations of every thread and forwards them to the allocator it replaced*/
+class FMobaCountingMalloc final : public FMalloc
+{
+public:
+
+	explicit FMobaCountingMalloc(FMalloc* InInner)
+		: Inner(InInner)
+	{
+	}
+
+	int64 GetAllocations() const { return FPlatformAtomics::AtomicRead(&Allocations); }
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		FPlatformAtomics::InterlockedIncrement(&Allocations);
+		return Inner->Malloc(Count, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+	{
+		FPlatformAtomics::InterlockedIncrement(&Allocations);
+		return Inner->TryMalloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Original == nullptr)
+		{
+			FPlatformAtomics::InterlockedIncrement(&Allocations);
+		}
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Original == nullptr)
+		{
+			FPlatformAtomics::InterlockedIncrement(&Allocations);
+		}
+		return Inner->TryRealloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override { Inner->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+	virtual bool Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar) override { return Inner->Exec(InWorld, Cmd, Ar); }
+	virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+private:
+
+	FMalloc* Inner;
+
+	volatile int64 Allocations = 0;
+};
+
+/**		One fighter of the benchmark and where it is in its swing*/
+struct FMobaBenchFighter
+{
+	ABattleMobaCharacter* Character = nullptr;
+
+	FTransform SpawnTransform;
+
+	float NextAttackTime = 0.0f;
+
+	float DisarmTime = -1.0f;
+
+	int32 ActiveAttack = 1;
+
+	float KnockoutTime = -1.0f;
+
+	float LastHealth = 0.0f;
+};
+
+UMobaCombatBenchCommandlet::UMobaCombatBenchCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UMobaCombatBenchCommandlet::Main(const FString& Params)
+{
+	const TCHAR* CommandLine = *Params;
+
+	int32 NumCharacters = 20;
+	float Seconds = 60.0f;
+	int32 Seed = 1;
+	float Fps = 30.0f;
+	FString CharacterPath;
+	FString ReportPath;
+	FParse::Value(CommandLine, TEXT("Characters="), NumCharacters);
+	FParse::Value(CommandLine, TEXT("Seconds="), Seconds);
+	FParse::Value(CommandLine, TEXT("Seed="), Seed);
+	FParse::Value(CommandLine, TEXT("Fps="), Fps);
+	FParse::Value(CommandLine, TEXT("Character="), CharacterPath);
+	FParse::Value(CommandLine, TEXT("Report="), ReportPath);
+
+	NumCharacters = FMath::Max(NumCharacters, 2);
+	Fps = FMath::Clamp(Fps, 1.0f, 1000.0f);
+	const float DeltaSeconds = 1.0f / Fps;
+	const int32 NumFrames = FMath::Max(FMath::CeilToInt(Seconds * Fps), 1);
+
+	//		the same seed gives the same fight, including the engine's own random calls
+	FMath::RandInit(Seed);
+	FMath::SRandInit(Seed);
+	FRandomStream Random(Seed);
+
+	//		character class and meshes as the game mode spawns them
+	const ABattleMobaGameMode* GameModeDefaults = nullptr;
+	if (UClass* GameModeClass = LoadClass<AGameModeBase>(nullptr, *UGameMapsSettings::GetGlobalDefaultGameMode()))
+	{
+		GameModeDefaults = Cast<ABattleMobaGameMode>(GameModeClass->GetDefaultObject());
+	}
+
+	UClass* CharacterClass = nullptr;
+	if (!CharacterPath.IsEmpty())
+	{
+		CharacterClass = LoadClass<ABattleMobaCharacter>(nullptr, *CharacterPath);
+	}
+	else if (GameModeDefaults)
+	{
+		CharacterClass = GameModeDefaults->GetSpawnedActor();
+	}
+
+	if (CharacterClass == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("MobaCombatBench: no character class, pass -Character=<class path> or set SpawnedActor on the default game mode"));
+		return 1;
+	}
+
+	TArray<USkeletalMesh*> Meshes;
+	TSubclassOf<APlayerState> PlayerStateClass = ABattleMobaPlayerState::StaticClass();
+	if (GameModeDefaults)
+	{
+		Meshes = GameModeDefaults->GetCharSelections();
+		Meshes.Remove(nullptr);
+		if (GameModeDefaults->PlayerStateClass && GameModeDefaults->PlayerStateClass->IsChildOf(ABattleMobaPlayerState::StaticClass()))
+		{
+			PlayerStateClass = GameModeDefaults->PlayerStateClass;
+		}
+	}
+
+	//		standalone world on a flat arena, maps would make runs depend on content changes
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone();
+	UWorld* World = GameInstance->GetWorld();
+
+	FURL URL(TEXT("?game=/Script/Engine.GameModeBase"));
+	World->SetGameMode(URL);
+
+	if (UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")))
+	{
+		AStaticMeshActor* Floor = World->SpawnActor<AStaticMeshActor>(FVector(0.0f, 0.0f, -50.0f), FRotator::ZeroRotator);
+		Floor->GetStaticMeshComponent()->SetStaticMesh(Cube);
+		Floor->SetActorScale3D(FVector(100.0f, 100.0f, 1.0f));
+	}
+
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	TArray<FMobaBenchFighter> Fighters;
+	for (int32 i = 0; i < NumCharacters; i++)
+	{
+		const bool bRadiant = (i % 2) == 0;
+		const int32 Rank = i / 2;
+		const FVector Location(bRadiant ? -BenchArenaWidth * 0.5f : BenchArenaWidth * 0.5f, (Rank - NumCharacters / 4) * 200.0f, 100.0f);
+		const FTransform SpawnTransform(FRotator(0.0f, bRadiant ? 0.0f : 180.0f, 0.0f), Location);
+
+		ABattleMobaCharacter* Character = World->SpawnActorDeferred<ABattleMobaCharacter>(CharacterClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (Character == nullptr)
+		{
+			continue;
+		}
+
+		Character->TeamName = bRadiant ? FName("Radiant") : FName("Dire");
+		if (Meshes.Num() > 0)
+		{
+			Character->CharMesh = Meshes[Random.RandHelper(Meshes.Num())];
+		}
+
+		//		damage and knockouts go through the player state as in a match
+		FActorSpawnParameters PlayerStateParams;
+		PlayerStateParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ABattleMobaPlayerState* PS = World->SpawnActor<ABattleMobaPlayerState>(PlayerStateClass, PlayerStateParams);
+		if (PS)
+		{
+			PS->TeamName = Character->TeamName;
+			PS->SpawnTransform = SpawnTransform;
+			Character->SetPlayerState(PS);
+		}
+
+		Character->FinishSpawning(SpawnTransform);
+		Character->SpawnDefaultController();
+		Character->ChooseBattleStyle(Random.RandRange(1, 3));
+
+		FMobaBenchFighter& Fighter = Fighters.AddDefaulted_GetRef();
+		Fighter.Character = Character;
+		Fighter.SpawnTransform = SpawnTransform;
+		Fighter.NextAttackTime = Random.FRandRange(0.0f, 1.0f);
+		Fighter.LastHealth = Character->GetHealth();
+	}
+
+	UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(World);
+	UMobaCombatTraceBatcher* Batcher = World->GetSubsystem<UMobaCombatTraceBatcher>();
+	const int64 QueriesBefore = Batcher ? Batcher->GetTotalQueries() : 0;
+
+	//		installed for good, blocks from the old allocator are still freed through it
+	static FMobaCountingMalloc* CountingMalloc = nullptr;
+	if (CountingMalloc == nullptr)
+	{
+		CountingMalloc = new FMobaCountingMalloc(GMalloc);
+		GMalloc = CountingMalloc;
+	}
+
+	TArray<double> FrameMs;
+	FrameMs.Reserve(NumFrames);
+	int64 Allocations = 0;
+	int32 Knockouts = 0;
+	int32 Respawns = 0;
+	int32 Hits = 0;
+	float SimTime = 0.0f;
+
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		const int64 AllocationsBefore = CountingMalloc->GetAllocations();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+
+		for (FMobaBenchFighter& Fighter : Fighters)
+		{
+			ABattleMobaCharacter* Character = Fighter.Character;
+
+			//		hits taken since the last frame
+			if (Character->GetHealth() < Fighter.LastHealth)
+			{
+				Hits++;
+			}
+			Fighter.LastHealth = Character->GetHealth();
+
+			if (Fighter.KnockoutTime >= 0.0f)
+			{
+				if (SimTime - Fighter.KnockoutTime >= BenchRespawnSeconds)
+				{
+					//		the pooled path of the game mode's respawn
+					Character->ParkForPool();
+					Character->ResetForRespawn(Fighter.SpawnTransform);
+					Fighter.KnockoutTime = -1.0f;
+					Fighter.DisarmTime = -1.0f;
+					Fighter.LastHealth = Character->GetHealth();
+					Respawns++;
+				}
+				continue;
+			}
+
+			if (Character->GetHealth() <= 0.0f)
+			{
+				Fighter.KnockoutTime = SimTime;
+				Knockouts++;
+				continue;
+			}
+
+			if (Fighter.DisarmTime >= 0.0f && SimTime >= Fighter.DisarmTime)
+			{
+				Character->AttackTrace(false, Fighter.ActiveAttack);
+				Character->FireTrace(Fighter.ActiveAttack);
+				Fighter.DisarmTime = -1.0f;
+			}
+
+			//		walk to the nearest enemy and swing when in reach
+			const FName Enemies = Character->TeamName == "Radiant" ? FName("Dire") : FName("Radiant");
+			ABattleMobaCharacter* Target = nullptr;
+			float TargetDistSq = MAX_flt;
+			for (ABattleMobaCharacter* Enemy : Registry->GetTeam<ABattleMobaCharacter>(Enemies))
+			{
+				const float DistSq = FVector::DistSquared(Character->GetActorLocation(), Enemy->GetActorLocation());
+				if (DistSq < TargetDistSq)
+				{
+					Target = Enemy;
+					TargetDistSq = DistSq;
+				}
+			}
+
+			if (Target == nullptr)
+			{
+				continue;
+			}
+
+			const FVector ToTarget = (Target->GetActorLocation() - Character->GetActorLocation()).GetSafeNormal2D();
+			Character->SetActorRotation(ToTarget.Rotation());
+
+			if (TargetDistSq > FMath::Square(BenchAttackRange))
+			{
+				Character->AddMovementInput(ToTarget, 1.0f);
+			}
+
+			else if (SimTime >= Fighter.NextAttackTime && Fighter.DisarmTime < 0.0f)
+			{
+				const FMobaSkillIndex& Skills = Character->GetSkillIndex();
+				if (const FActionSkill* Skill = Skills.GetSkill(Random.RandHelper(FMath::Max(Skills.Num(), 1))))
+				{
+					bool bCooldown = false;
+					float CooldownVal = 0.0f;
+					Character->GetButtonSkillAction(Skill->keys, Skill->ButtonName, bCooldown, CooldownVal);
+				}
+
+				Fighter.ActiveAttack = Random.RandRange(1, 4);
+				Character->AttackTrace(true, Fighter.ActiveAttack);
+				Fighter.DisarmTime = SimTime + BenchSwingSeconds;
+				Fighter.NextAttackTime = SimTime + Random.FRandRange(0.6f, 1.2f);
+			}
+		}
+
+		FApp::SetDeltaTime(DeltaSeconds);
+		World->Tick(LEVELTICK_All, DeltaSeconds);
+		FTickableGameObject::TickObjects(World, LEVELTICK_All, false, DeltaSeconds);
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		GFrameCounter++;
+
+		FrameMs.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+		Allocations += CountingMalloc->GetAllocations() - AllocationsBefore;
+		SimTime += DeltaSeconds;
+	}
+
+	const int64 Traces = Batcher ? Batcher->GetTotalQueries() - QueriesBefore : 0;
+
+	double TotalMs = 0.0;
+	for (double Ms : FrameMs)
+	{
+		TotalMs += Ms;
+	}
+	FrameMs.Sort();
+
+	const double MeanMs = TotalMs / FrameMs.Num();
+	const double P99Ms = FrameMs[FMath::Min(FMath::FloorToInt(FrameMs.Num() * 0.99f), FrameMs.Num() - 1)];
+	const double TracesPerSecond = Traces / double(SimTime);
+	const double AllocationsPerFrame = double(Allocations) / FrameMs.Num();
+
+	UE_LOG(LogTemp, Display, TEXT("MobaCombatBench: %d characters, %.0f s at %.0f fps, seed %d"), Fighters.Num(), SimTime, Fps, Seed);
+	UE_LOG(LogTemp, Display, TEXT("MobaCombatBench: game thread %.3f ms mean, %.3f ms p99"), MeanMs, P99Ms);
+	UE_LOG(LogTemp, Display, TEXT("MobaCombatBench: %.1f traces/s, %.1f allocations/frame"), TracesPerSecond, AllocationsPerFrame);
+	UE_LOG(LogTemp, Display, TEXT("MobaCombatBench: %d hits, %d knockouts, %d respawns"), Hits, Knockouts, Respawns);
+
+	if (!ReportPath.IsEmpty())
+	{
+		const FString Report = FString::Printf(TEXT("Characters,Seconds,Fps,Seed,MeanMs,P99Ms,TracesPerSecond,AllocationsPerFrame,Hits,Knockouts,Respawns\n%d,%.0f,%.0f,%d,%.3f,%.3f,%.1f,%.1f,%d,%d,%d\n"),
+			Fighters.Num(), SimTime, Fps, Seed, MeanMs, P99Ms, TracesPerSecond, AllocationsPerFrame, Hits, Knockouts, Respawns);
+		FFileHelper::SaveStringToFile(Report, *ReportPath);
+	}
+
+	World->DestroyWorld(false);
+	GEngine->DestroyWorldContext(World);
+	GameInstance->Shutdown();
+	GameInstance->RemoveFromRoot();
+
+	return 0;
+}
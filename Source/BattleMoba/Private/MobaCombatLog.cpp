@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaCombatLog.h"
+
+#if MOBA_COMBAT_LOG
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/Atomic.h"
+#include "UObject/UObjectArray.h"
+
+namespace MobaCombatLog
+{
+	struct FRecord
+	{
+		uint64 Cycles;
+		uint32 Frame;
+		int32 SourceIndex;
+		//Tells a reused index apart from the source it had when written
+		int32 SourceSerial;
+		int32 Int;
+		float A;
+		float B;
+		EMobaCombatEvent Type;
+	};
+
+	//Records kept per thread, a power of two
+	static constexpr uint32 RingSize = 4096;
+
+	struct FRing
+	{
+		uint32 ThreadId = 0;
+
+		//Only the owning thread advances it, a record is complete once the index moves past it
+		TAtomic<uint32> WriteIndex { 0 };
+
+		FRecord Records[RingSize];
+	};
+
+	//Event name followed by the labels of Int, A and B, nullptr when unused
+	static const TCHAR* const EventLabels[int32(EMobaCombatEvent::Count)][4] =
+	{
+		{ TEXT("SwipeInput"),		TEXT("touch"),		TEXT("x"),			TEXT("y") },
+		{ TEXT("MoveInput"),		nullptr,			TEXT("x"),			TEXT("y") },
+		{ TEXT("FireTrace"),		TEXT("attack"),		TEXT("canAttack"),	TEXT("applyHit") },
+		{ TEXT("AttackTrace"),		TEXT("attack"),		TEXT("start"),		nullptr },
+		{ TEXT("SkillOnCooldown"),	TEXT("skill"),		nullptr,			nullptr },
+		{ TEXT("RotateToTarget"),	nullptr,			TEXT("speed"),		nullptr },
+		{ TEXT("HitReceived"),		TEXT("direction"),	TEXT("damage"),		nullptr },
+		{ TEXT("HitResolved"),		TEXT("kind"),		TEXT("health"),		nullptr },
+		{ TEXT("HealthChanged"),	nullptr,			TEXT("health"),		TEXT("max") },
+		{ TEXT("DamageApplied"),	nullptr,			TEXT("damage"),		nullptr },
+	};
+
+	//Rings are never freed so a crash dump can still read the ones of finished threads
+	static FCriticalSection RingsLock;
+	static TArray<FRing*> Rings;
+
+	static void DumpOnCrash()
+	{
+		const FString Path = FMobaCombatLog::Dump();
+		UE_LOG(LogTemp, Error, TEXT("Combat trace written to %s"), *Path);
+	}
+
+	static FRing* CreateRing()
+	{
+		FRing* Ring = new FRing();
+		Ring->ThreadId = FPlatformTLS::GetCurrentThreadId();
+
+		FScopeLock Lock(&RingsLock);
+		if (Rings.Num() == 0)
+		{
+			FCoreDelegates::OnHandleSystemError.AddStatic(&DumpOnCrash);
+		}
+		Rings.Add(Ring);
+		return Ring;
+	}
+
+	static FRing& GetRing()
+	{
+		static thread_local FRing* Ring = nullptr;
+		if (Ring == nullptr)
+		{
+			Ring = CreateRing();
+		}
+		return *Ring;
+	}
+
+	static FString FormatRecord(const FRecord& Record, uint64 FirstCycles)
+	{
+		const TCHAR* const* Labels = EventLabels[FMath::Min(int32(Record.Type), int32(EMobaCombatEvent::Count) - 1)];
+
+		FString Source = TEXT("None");
+		if (Record.SourceIndex != INDEX_NONE)
+		{
+			const FUObjectItem* Item = GUObjectArray.IndexToObject(Record.SourceIndex);
+			const bool bSameObject = Item && Item->Object && Item->GetSerialNumber() == Record.SourceSerial;
+			Source = bSameObject ? static_cast<UObject*>(Item->Object)->GetName() : FString::Printf(TEXT("#%d (stale)"), Record.SourceIndex);
+		}
+
+		FString Line = FString::Printf(TEXT("%10.6f frame %u %-16s %s"), FPlatformTime::ToSeconds64(Record.Cycles - FirstCycles), Record.Frame, Labels[0], *Source);
+		if (Labels[1])
+		{
+			Line += FString::Printf(TEXT(" %s=%d"), Labels[1], Record.Int);
+		}
+		if (Labels[2])
+		{
+			Line += FString::Printf(TEXT(" %s=%.2f"), Labels[2], Record.A);
+		}
+		if (Labels[3])
+		{
+			Line += FString::Printf(TEXT(" %s=%.2f"), Labels[3], Record.B);
+		}
+		return Line;
+	}
+}
+
+void FMobaCombatLog::Write(EMobaCombatEvent Type, const UObject* Source, int32 Int, float A, float B)
+{
+	using namespace MobaCombatLog;
+
+	FRing& Ring = GetRing();
+	const uint32 Index = Ring.WriteIndex.Load(EMemoryOrder::Relaxed);
+
+	FRecord& Record = Ring.Records[Index & (RingSize - 1)];
+	Record.Cycles = FPlatformTime::Cycles64();
+	Record.Frame = uint32(GFrameCounter);
+	Record.SourceIndex = Source ? GUObjectArray.ObjectToIndex(Source) : INDEX_NONE;
+	Record.SourceSerial = Source ? GUObjectArray.AllocateSerialNumber(Record.SourceIndex) : 0;
+	Record.Int = Int;
+	Record.A = A;
+	Record.B = B;
+	Record.Type = Type;
+
+	Ring.WriteIndex.Store(Index + 1, EMemoryOrder::SequentiallyConsistent);
+}
+
+FString FMobaCombatLog::Dump(const FString& Filename)
+{
+	using namespace MobaCombatLog;
+
+	//		a record being overwritten while this copies may come out torn, which a debug dump can live with
+	TArray<FRecord> Records;
+	int32 NumRings = 0;
+	{
+		FScopeLock Lock(&RingsLock);
+		NumRings = Rings.Num();
+		for (const FRing* Ring : Rings)
+		{
+			const uint32 End = Ring->WriteIndex.Load();
+			const uint32 Start = End > RingSize ? End - RingSize : 0;
+			for (uint32 i = Start; i < End; ++i)
+			{
+				Records.Add(Ring->Records[i & (RingSize - 1)]);
+			}
+		}
+	}
+
+	Records.Sort([](const FRecord& X, const FRecord& Y) { return X.Cycles < Y.Cycles; });
+
+	TArray<FString> Lines;
+	Lines.Reserve(Records.Num() + 1);
+	Lines.Add(FString::Printf(TEXT("BattleMoba combat trace, %d records from %d threads"), Records.Num(), NumRings));
+
+	const uint64 FirstCycles = Records.Num() > 0 ? Records[0].Cycles : 0;
+	for (const FRecord& Record : Records)
+	{
+		Lines.Add(FormatRecord(Record, FirstCycles));
+	}
+
+	const FString Path = Filename.IsEmpty()
+		? FPaths::Combine(FPaths::ProjectLogDir(), FString::Printf(TEXT("CombatTrace-%s.log"), *FDateTime::Now().ToString()))
+		: Filename;
+
+	FFileHelper::SaveStringArrayToFile(Lines, *Path);
+	return Path;
+}
+
+static FAutoConsoleCommand MobaCombatLogDumpCommand(
+	TEXT("Moba.CombatLog.Dump"),
+	TEXT("Write the combat trace rings to a file. Optional argument: the file name, a timestamped file in the log directory otherwise."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString Path = FMobaCombatLog::Dump(Args.Num() > 0 ? Args[0] : FString());
+		UE_LOG(LogTemp, Log, TEXT("Moba.CombatLog.Dump: written to %s"), *Path);
+	}));
+
+#endif
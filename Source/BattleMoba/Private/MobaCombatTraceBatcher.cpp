@@ -0,0 +1,321 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaCombatTraceBatcher.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "DrawDebugHelpers.h"
+#include "HAL/IConsoleManager.h"
+
+#include "BattleMoba.h"
+#include "BattleMobaCharacter.h"
+#include "MobaHitboxSet.h"
+#include "MobaLagCompensation.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaTraceSubmit, "Combat Trace Submit");
+MOBA_DECLARE_HOT_PATH(STAT_MobaTraceResolve, "Combat Trace Resolve");
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Trace Requests"), STAT_MobaTraceRequests, STATGROUP_BattleMoba);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat Trace Queries"), STAT_MobaTraceQueries, STATGROUP_BattleMoba);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Armed Attack Sweeps"), STAT_MobaArmedSweeps, STATGROUP_BattleMoba);
+
+static TAutoConsoleVariable<int32> CVarDrawHitboxes(
+	TEXT("Moba.DrawHitboxes"),
+	0,
+	TEXT("Draw attack hitbox sweeps on the server.\n")
+	TEXT("0: off, 1: on"),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarAttackSweepMaxDuration(
+	TEXT("Moba.AttackSweep.MaxDuration"),
+	1.0f,
+	TEXT("Seconds an armed attack keeps sweeping without an AttackTrace end before it is dropped."),
+	ECVF_Default);
+
+void UMobaCombatTraceBatcher::QueueAttack(ABattleMobaCharacter* Attacker, EMobaCombatTraceKind Kind, int32 ActiveAttack, float RewindTime)
+{
+	AddRequest(Attacker, Kind, ActiveAttack, RewindTime, nullptr);
+}
+
+bool UMobaCombatTraceBatcher::ArmAttack(ABattleMobaCharacter* Attacker, int32 ActiveAttack, float RewindTime)
+{
+	if (Attacker == nullptr)
+	{
+		return false;
+	}
+
+	FArmedAttack* Armed = ArmedAttacks.FindByPredicate([Attacker](const FArmedAttack& Entry) { return Entry.Attacker.Get() == Attacker; });
+
+	//		repeated starts of the same attack keep sweeping from where the limb was
+	if (Armed != nullptr && Armed->ActiveAttack == ActiveAttack)
+	{
+		return false;
+	}
+
+	if (Armed == nullptr)
+	{
+		Armed = &ArmedAttacks.AddDefaulted_GetRef();
+		Armed->Attacker = Attacker;
+	}
+
+	Armed->ActiveAttack = ActiveAttack;
+	Armed->RewindDelay = GetWorld()->GetTimeSeconds() - RewindTime;
+	Armed->ArmedTime = GetWorld()->GetTimeSeconds();
+	Armed->PreviousCenters.Reset();
+	return true;
+}
+
+void UMobaCombatTraceBatcher::DisarmAttack(ABattleMobaCharacter* Attacker)
+{
+	ArmedAttacks.RemoveAllSwap([Attacker](const FArmedAttack& Entry) { return Entry.Attacker.Get() == Attacker; });
+}
+
+void UMobaCombatTraceBatcher::AddRequest(ABattleMobaCharacter* Attacker, EMobaCombatTraceKind Kind, int32 ActiveAttack, float RewindTime, TArray<FVector, TInlineAllocator<2>>* PreviousCenters)
+{
+	if (Attacker == nullptr || Attacker->GetMesh()->SkeletalMesh == nullptr)
+	{
+		return;
+	}
+
+	const TArray<FMobaHitboxVolume>* Volumes = Attacker->GetAttackSlotVolumes(ActiveAttack);
+	if (Volumes == nullptr || Volumes->Num() == 0)
+	{
+		return;
+	}
+
+	const int32 RequestIndex = PendingRequests.Num();
+
+	FCombatRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.Attacker = Attacker;
+	Request.Kind = Kind;
+	Request.ActiveAttack = ActiveAttack;
+	Request.RewindTime = RewindTime;
+
+	/**		resolve the probes against the pose the attacker has right now, the sweep itself runs later*/
+	const FVector Direction = Attacker->GetActorForwardVector();
+	const bool bFromPrevious = PreviousCenters != nullptr && PreviousCenters->Num() == Volumes->Num();
+	if (PreviousCenters != nullptr && !bFromPrevious)
+	{
+		PreviousCenters->Reset();
+	}
+
+	for (int32 i = 0; i < Volumes->Num(); ++i)
+	{
+		FCombatQuery& Query = PendingQueries.AddDefaulted_GetRef();
+		Query.RequestIndex = RequestIndex;
+
+		FVector Center;
+		(*Volumes)[i].GetWorldBox(Attacker->GetMesh(), Center, Query.Rotation, Query.Extent);
+
+		//		swept from last frame's position so fast limbs cannot skip through a target
+		Query.Start = bFromPrevious ? (*PreviousCenters)[i] : Center;
+		Query.End = bFromPrevious ? Center : Center + (Direction * Attacker->GetTraceDistance());
+
+		if (PreviousCenters != nullptr)
+		{
+			if (bFromPrevious)
+			{
+				(*PreviousCenters)[i] = Center;
+			}
+			else
+			{
+				PreviousCenters->Add(Center);
+			}
+		}
+	}
+}
+
+void UMobaCombatTraceBatcher::QueueArmedSweeps()
+{
+	UWorld* World = GetWorld();
+	const float Now = World->GetTimeSeconds();
+	const float MaxDuration = CVarAttackSweepMaxDuration.GetValueOnGameThread();
+
+	for (int32 i = ArmedAttacks.Num() - 1; i >= 0; --i)
+	{
+		FArmedAttack& Armed = ArmedAttacks[i];
+		ABattleMobaCharacter* Attacker = Armed.Attacker.Get();
+
+		//		a missing AttackTrace end (interrupted montage, ragdoll) must not sweep forever
+		if (Attacker == nullptr || (MaxDuration > 0.0f && Now - Armed.ArmedTime > MaxDuration))
+		{
+			ArmedAttacks.RemoveAtSwap(i);
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_MobaArmedSweeps);
+		AddRequest(Attacker, EMobaCombatTraceKind::AttackTrace, Armed.ActiveAttack, FMobaLagCompensation::ClampRewindTime(World, Now - Armed.RewindDelay), &Armed.PreviousCenters);
+	}
+}
+
+void UMobaCombatTraceBatcher::Deinitialize()
+{
+	ArmedAttacks.Empty();
+	PendingRequests.Empty();
+	PendingQueries.Empty();
+	InFlightRequests.Empty();
+	InFlightQueries.Empty();
+	InFlightHits.Empty();
+	OutstandingTraces = 0;
+	TraceDelegate.Unbind();
+
+	Super::Deinitialize();
+}
+
+void UMobaCombatTraceBatcher::Tick(float DeltaTime)
+{
+	//		should never happen, async traces finish at the start of the frame after they were issued
+	if (OutstandingTraces > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Combat traces still outstanding at submit time, resolving %d late"), OutstandingTraces);
+		OutstandingTraces = 0;
+		ResolveInFlight();
+	}
+
+	QueueArmedSweeps();
+	SubmitPending();
+}
+
+bool UMobaCombatTraceBatcher::IsTickable() const
+{
+	return !IsTemplate() && (PendingRequests.Num() > 0 || ArmedAttacks.Num() > 0);
+}
+
+ETickableTickType UMobaCombatTraceBatcher::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UMobaCombatTraceBatcher::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMobaCombatTraceBatcher, STATGROUP_Tickables);
+}
+
+void UMobaCombatTraceBatcher::SubmitPending()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || PendingQueries.Num() == 0)
+	{
+		PendingRequests.Reset();
+		PendingQueries.Reset();
+		return;
+	}
+
+	MOBA_SCOPE_CYCLE(STAT_MobaTraceSubmit);
+	INC_DWORD_STAT_BY(STAT_MobaTraceRequests, PendingRequests.Num());
+	INC_DWORD_STAT_BY(STAT_MobaTraceQueries, PendingQueries.Num());
+	TotalQueries += PendingQueries.Num();
+
+	Swap(InFlightRequests, PendingRequests);
+	Swap(InFlightQueries, PendingQueries);
+	PendingRequests.Reset();
+	PendingQueries.Reset();
+
+	InFlightHits.SetNum(InFlightQueries.Num());
+	for (TArray<FHitResult>& Hits : InFlightHits)
+	{
+		Hits.Reset();
+	}
+
+	if (!TraceDelegate.IsBound())
+	{
+		TraceDelegate.BindUObject(this, &UMobaCombatTraceBatcher::OnTraceCompleted);
+	}
+
+	static const FCollisionObjectQueryParams ObjectParams(ECC_TO_BITFIELD(ECC_PhysicsBody));
+	const FVector Slack(FMobaLagCompensation::GetBroadphaseSlack());
+
+	for (int32 QueryIndex = 0; QueryIndex < InFlightQueries.Num(); ++QueryIndex)
+	{
+		const FCombatQuery& Query = InFlightQueries[QueryIndex];
+		const ABattleMobaCharacter* Attacker = InFlightRequests[Query.RequestIndex].Attacker.Get();
+		if (Attacker == nullptr)
+		{
+			continue;
+		}
+
+		World->AsyncSweepByObjectType(EAsyncTraceType::Multi, Query.Start, Query.End, Query.Rotation, ObjectParams, FCollisionShape::MakeBox(Query.Extent + Slack), Attacker->GetAttackTraceParams(), &TraceDelegate, QueryIndex);
+		++OutstandingTraces;
+
+#if ENABLE_DRAW_DEBUG
+		if (CVarDrawHitboxes.GetValueOnGameThread() != 0)
+		{
+			DrawDebugBox(World, Query.Start, Query.Extent, Query.Rotation, FColor::Red, false, 1.0f);
+			DrawDebugBox(World, Query.End, Query.Extent, Query.Rotation, FColor::Red, false, 1.0f);
+		}
+#endif
+	}
+
+	if (OutstandingTraces == 0)
+	{
+		ResolveInFlight();
+	}
+}
+
+void UMobaCombatTraceBatcher::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	if (InFlightHits.IsValidIndex(Datum.UserData))
+	{
+		InFlightHits[Datum.UserData] = MoveTemp(Datum.OutHits);
+	}
+
+	if (--OutstandingTraces <= 0)
+	{
+		OutstandingTraces = 0;
+		ResolveInFlight();
+	}
+}
+
+void UMobaCombatTraceBatcher::ResolveInFlight()
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaTraceResolve);
+
+	const bool bNarrowPhase = FMobaLagCompensation::GetBroadphaseSlack() > 0.0f;
+
+	for (int32 QueryIndex = 0; QueryIndex < InFlightQueries.Num(); ++QueryIndex)
+	{
+		const FCombatQuery& Query = InFlightQueries[QueryIndex];
+		FCombatRequest& Request = InFlightRequests[Query.RequestIndex];
+
+		for (const FHitResult& BroadHit : InFlightHits[QueryIndex])
+		{
+			UPrimitiveComponent* HitComponent = BroadHit.GetComponent();
+			if (HitComponent == nullptr)
+			{
+				continue;
+			}
+
+			if (!bNarrowPhase)
+			{
+				Request.Hits.Add(BroadHit);
+				continue;
+			}
+
+			/**		targets are tested where they stood at RewindTime, everything else where it is now*/
+			FTransform Correction = FTransform::Identity;
+			const ABattleMobaCharacter* HitCharacter = Cast<ABattleMobaCharacter>(BroadHit.GetActor());
+			if (HitCharacter == nullptr || HitCharacter->GetMesh() != HitComponent || !FMobaLagCompensation::GetRewindCorrection(HitCharacter, Request.RewindTime, Correction))
+			{
+				Correction = FTransform::Identity;
+			}
+
+			FHitResult NarrowHit;
+			if (HitComponent->SweepComponent(NarrowHit, Correction.TransformPosition(Query.Start), Correction.TransformPosition(Query.End), Correction.GetRotation() * Query.Rotation, FCollisionShape::MakeBox(Query.Extent)))
+			{
+				Request.Hits.Add(BroadHit);
+			}
+		}
+	}
+
+	//		requests are handed back in the order they were queued
+	for (FCombatRequest& Request : InFlightRequests)
+	{
+		if (ABattleMobaCharacter* Attacker = Request.Attacker.Get())
+		{
+			Attacker->ResolveAttackTrace(Request.Kind, Request.ActiveAttack, Request.Hits);
+		}
+	}
+
+	InFlightRequests.Reset();
+	InFlightQueries.Reset();
+}
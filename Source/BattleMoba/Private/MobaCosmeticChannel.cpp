@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaCosmeticChannel.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+
+#include "BattleMoba.h"
+#include "BattleMobaCharacter.h"
+#include "BattleMobaPC.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaCosmeticFlush, "Cosmetic Flush");
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetic Events Sent"), STAT_MobaCosmeticEventsSent, STATGROUP_BattleMoba);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cosmetic Events Culled"), STAT_MobaCosmeticEventsCulled, STATGROUP_BattleMoba);
+
+static TAutoConsoleVariable<int32> CVarMobaCosmeticRelevancy(
+	TEXT("Moba.Cosmetic.RelevancyCull"),
+	1,
+	TEXT("Drop cosmetic events for connections the character is not relevant to.\n")
+	TEXT("0: send to every connection, 1: relevant connections only"),
+	ECVF_Default);
+
+void FMobaCosmeticBatch::Apply() const
+{
+	for (const FMobaSocketEvent& Event : Sockets)
+	{
+		if (Event.Character != nullptr && Event.SocketName != NAME_None)
+		{
+			Event.Character->SetLocalActiveSocket(Event.SocketName);
+		}
+	}
+
+	for (const FMobaRotationEvent& Event : Rotations)
+	{
+		if (Event.Character != nullptr)
+		{
+			Event.Character->SetActorRotation(Event.Rotation);
+		}
+	}
+
+	for (const FMobaEffectEvent& Event : Effects)
+	{
+		if (Event.EmitActor != nullptr)
+		{
+			Event.EmitActor->SpawnHitEffect();
+		}
+	}
+}
+
+void UMobaCosmeticChannel::QueueEffect(ABattleMobaCharacter* EmitActor)
+{
+	if (EmitActor == nullptr)
+	{
+		return;
+	}
+
+	FMobaEffectEvent& Event = Pending.Effects.AddDefaulted_GetRef();
+	Event.EmitActor = EmitActor;
+
+	//		the listen server host sees it now, remote connections on flush
+	FMobaCosmeticBatch Local;
+	Local.Effects.Add(Event);
+	Local.Apply();
+}
+
+void UMobaCosmeticChannel::QueueRotation(ABattleMobaCharacter* Character, const FRotator& Rotation)
+{
+	if (Character == nullptr)
+	{
+		return;
+	}
+
+	Character->SetActorRotation(Rotation);
+
+	if (const int32* Index = RotationIndex.Find(Character))
+	{
+		Pending.Rotations[*Index].Rotation = Rotation;
+		return;
+	}
+
+	RotationIndex.Add(Character, Pending.Rotations.Num());
+
+	FMobaRotationEvent& Event = Pending.Rotations.AddDefaulted_GetRef();
+	Event.Character = Character;
+	Event.Rotation = Rotation;
+}
+
+void UMobaCosmeticChannel::QueueActiveSocket(ABattleMobaCharacter* Character, FName SocketName)
+{
+	if (Character == nullptr || SocketName == NAME_None)
+	{
+		return;
+	}
+
+	Character->SetLocalActiveSocket(SocketName);
+
+	if (const int32* Index = SocketIndex.Find(Character))
+	{
+		Pending.Sockets[*Index].SocketName = SocketName;
+		return;
+	}
+
+	SocketIndex.Add(Character, Pending.Sockets.Num());
+
+	FMobaSocketEvent& Event = Pending.Sockets.AddDefaulted_GetRef();
+	Event.Character = Character;
+	Event.SocketName = SocketName;
+}
+
+void UMobaCosmeticChannel::Deinitialize()
+{
+	Pending = FMobaCosmeticBatch();
+	RotationIndex.Reset();
+	SocketIndex.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMobaCosmeticChannel::Tick(float DeltaTime)
+{
+	Flush();
+}
+
+void UMobaCosmeticChannel::BuildBatchFor(APlayerController* PC, FMobaCosmeticBatch& OutBatch) const
+{
+	const bool bCull = CVarMobaCosmeticRelevancy.GetValueOnGameThread() != 0;
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	AActor* ViewTarget = PC->GetViewTarget();
+
+	auto IsRelevant = [&](const ABattleMobaCharacter* Character)
+	{
+		if (Character == nullptr)
+		{
+			return false;
+		}
+		if (!bCull || Character->IsNetRelevantFor(PC, ViewTarget ? ViewTarget : PC, ViewLocation))
+		{
+			return true;
+		}
+		INC_DWORD_STAT(STAT_MobaCosmeticEventsCulled);
+		return false;
+	};
+
+	for (const FMobaSocketEvent& Event : Pending.Sockets)
+	{
+		if (IsRelevant(Event.Character))
+		{
+			OutBatch.Sockets.Add(Event);
+		}
+	}
+	for (const FMobaRotationEvent& Event : Pending.Rotations)
+	{
+		if (IsRelevant(Event.Character))
+		{
+			OutBatch.Rotations.Add(Event);
+		}
+	}
+	for (const FMobaEffectEvent& Event : Pending.Effects)
+	{
+		if (IsRelevant(Event.EmitActor))
+		{
+			OutBatch.Effects.Add(Event);
+		}
+	}
+}
+
+void UMobaCosmeticChannel::Flush()
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaCosmeticFlush);
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		//		local controllers already saw the events when they were queued
+		ABattleMobaPC* PC = Cast<ABattleMobaPC>(It->Get());
+		if (PC == nullptr || PC->IsLocalController())
+		{
+			continue;
+		}
+
+		FMobaCosmeticBatch Batch;
+		BuildBatchFor(PC, Batch);
+
+		if (!Batch.IsEmpty())
+		{
+			INC_DWORD_STAT_BY(STAT_MobaCosmeticEventsSent, Batch.Sockets.Num() + Batch.Rotations.Num() + Batch.Effects.Num());
+			PC->ClientCosmeticEvents(Batch);
+		}
+	}
+
+	Pending.Sockets.Reset();
+	Pending.Rotations.Reset();
+	Pending.Effects.Reset();
+	RotationIndex.Reset();
+	SocketIndex.Reset();
+}
+
+bool UMobaCosmeticChannel::IsTickable() const
+{
+	return !IsTemplate() && !Pending.IsEmpty();
+}
+
+ETickableTickType UMobaCosmeticChannel::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UMobaCosmeticChannel::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMobaCosmeticChannel, STATGROUP_Tickables);
+}
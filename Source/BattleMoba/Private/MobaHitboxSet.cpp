@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaHitboxSet.h"
+#include "Engine/World.h"
+#include "Components/SkeletalMeshComponent.h"
+
+void FMobaHitboxVolume::GetWorldBox(const USkeletalMeshComponent* Mesh, FVector& OutCenter, FQuat& OutRotation, FVector& OutExtent) const
+{
+	const FTransform SocketTransform = Mesh->GetSocketTransform(SocketName);
+
+	OutCenter = SocketTransform.TransformPosition(LocalCenter);
+	OutRotation = SocketTransform.GetRotation();
+	OutExtent = LocalExtent * SocketTransform.GetScale3D().GetAbs();
+}
+
+void UMobaHitboxSet::PostLoad()
+{
+	Super::PostLoad();
+
+	CompileSlots(AttackSlots, CompiledSlots);
+}
+
+#if WITH_EDITOR
+void UMobaHitboxSet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	CompileSlots(AttackSlots, CompiledSlots);
+}
+#endif
+
+const TArray<FMobaHitboxVolume>* UMobaHitboxSet::GetSlotVolumes(int32 ActiveAttack) const
+{
+	//activeAttack starts from 1
+	const int32 SlotIndex = ActiveAttack - 1;
+	return CompiledSlots.IsValidIndex(SlotIndex) ? &CompiledSlots[SlotIndex] : nullptr;
+}
+
+const TArray<FMobaHitboxVolume>* UMobaHitboxSet::GetDefaultSlotVolumes(int32 ActiveAttack)
+{
+	static TArray<TArray<FMobaHitboxVolume>> DefaultVolumes;
+
+	if (DefaultVolumes.Num() == 0)
+	{
+		//Probe offsets are the old LPC/RPC/LKC/RKC box locations already resolved into socket space
+		auto MakeSlot = [](FName SlotName, FName SocketName, const TArray<float>& Offsets)
+		{
+			FMobaHitboxSlot Slot;
+			Slot.SlotName = SlotName;
+			for (float X : Offsets)
+			{
+				FMobaHitboxProbe Probe;
+				Probe.SocketName = SocketName;
+				Probe.LocalOffset = FVector(X, 0.0f, 0.0f);
+				Probe.Extent = FVector(3.0f, 5.0f, 5.0f);
+				Slot.Probes.Add(Probe);
+			}
+			return Slot;
+		};
+
+		TArray<FMobaHitboxSlot> DefaultSlots;
+		DefaultSlots.Add(MakeSlot("LeftPunch", "hand_l", { -15.0f, -10.0f, -5.0f, 0.0f, 5.0f, 10.0f }));
+		DefaultSlots.Add(MakeSlot("RightPunch", "hand_r", { 15.0f, 10.0f, 5.0f, 0.0f, -5.0f, -10.0f }));
+		DefaultSlots.Add(MakeSlot("LeftKick", "calf_twist_01_l", { 10.0f, 3.0f, -4.0f, -10.0f, -15.0f, -21.0f }));
+		DefaultSlots.Add(MakeSlot("RightKick", "calf_twist_01_r", { -10.0f, -3.0f, 4.0f, 10.0f, 15.0f, 21.0f }));
+
+		CompileSlots(DefaultSlots, DefaultVolumes);
+	}
+
+	const int32 SlotIndex = ActiveAttack - 1;
+	return DefaultVolumes.IsValidIndex(SlotIndex) ? &DefaultVolumes[SlotIndex] : nullptr;
+}
+
+void UMobaHitboxSet::CompileSlots(const TArray<FMobaHitboxSlot>& Slots, TArray<TArray<FMobaHitboxVolume>>& OutVolumes)
+{
+	OutVolumes.Reset(Slots.Num());
+
+	for (const FMobaHitboxSlot& Slot : Slots)
+	{
+		//Group probes by socket so each socket costs a single sweep
+		TArray<FName> Sockets;
+		TArray<FBox> Bounds;
+
+		for (const FMobaHitboxProbe& Probe : Slot.Probes)
+		{
+			const FBox ProbeBox(Probe.LocalOffset - Probe.Extent, Probe.LocalOffset + Probe.Extent);
+
+			const int32 Index = Sockets.Find(Probe.SocketName);
+			if (Index == INDEX_NONE)
+			{
+				Sockets.Add(Probe.SocketName);
+				Bounds.Add(ProbeBox);
+			}
+			else
+			{
+				Bounds[Index] += ProbeBox;
+			}
+		}
+
+		TArray<FMobaHitboxVolume>& Volumes = OutVolumes.AddDefaulted_GetRef();
+		for (int32 i = 0; i < Sockets.Num(); ++i)
+		{
+			FMobaHitboxVolume Volume;
+			Volume.SocketName = Sockets[i];
+			Volume.LocalCenter = Bounds[i].GetCenter();
+			Volume.LocalExtent = Bounds[i].GetExtent();
+			Volumes.Add(Volume);
+		}
+	}
+}
@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaLagCompensation.h"
+#include "Engine/World.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+
+#include "BattleMoba.h"
+#include "BattleMobaCharacter.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaRewind, "Lag Compensation Rewind");
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rewound Targets"), STAT_MobaRewindCount, STATGROUP_BattleMoba);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Rewind Depth (ms)"), STAT_MobaRewindDepth, STATGROUP_BattleMoba);
+
+static TAutoConsoleVariable<int32> CVarLagCompensation(
+	TEXT("Moba.LagCompensation"),
+	1,
+	TEXT("Rewind hurtboxes to the attacker's timestamp before tracing attacks.\n")
+	TEXT("0: off, 1: on"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLagCompensationMaxRewind(
+	TEXT("Moba.LagCompensation.MaxRewind"),
+	0.25f,
+	TEXT("Oldest point in time, in seconds, the server rewinds hurtboxes to."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLagCompensationSlack(
+	TEXT("Moba.LagCompensation.BroadphaseSlack"),
+	100.0f,
+	TEXT("Extra extent, in unreal units, added to attack queries so rewound targets are still found."),
+	ECVF_Default);
+
+void FMobaPoseHistory::Record(float Time, const FTransform& MeshTransform)
+{
+	//		one sample per server frame is enough
+	if (Count > 0 && GetSample(0).Time >= Time)
+	{
+		return;
+	}
+
+	Samples[Head].Time = Time;
+	Samples[Head].MeshTransform = MeshTransform;
+
+	Head = (Head + 1) % Capacity;
+	Count = FMath::Min(Count + 1, Capacity);
+}
+
+const FMobaPoseSample& FMobaPoseHistory::GetSample(int32 AgeIndex) const
+{
+	//AgeIndex 0 is the latest sample
+	return Samples[(Head - 1 - AgeIndex + Capacity) % Capacity];
+}
+
+bool FMobaPoseHistory::Sample(float Time, FTransform& OutTransform) const
+{
+	if (Count == 0 || Time >= GetSample(0).Time)
+	{
+		return false;
+	}
+
+	for (int32 i = 1; i < Count; ++i)
+	{
+		const FMobaPoseSample& Older = GetSample(i);
+		if (Older.Time <= Time)
+		{
+			const FMobaPoseSample& Newer = GetSample(i - 1);
+			const float Alpha = (Time - Older.Time) / FMath::Max(Newer.Time - Older.Time, KINDA_SMALL_NUMBER);
+
+			OutTransform.Blend(Older.MeshTransform, Newer.MeshTransform, Alpha);
+			return true;
+		}
+	}
+
+	//		older than the buffer, use the oldest pose we have
+	OutTransform = GetSample(Count - 1).MeshTransform;
+	return true;
+}
+
+void FMobaPoseHistory::Reset()
+{
+	Head = 0;
+	Count = 0;
+}
+
+bool FMobaLagCompensation::IsEnabled()
+{
+	return CVarLagCompensation.GetValueOnGameThread() != 0;
+}
+
+float FMobaLagCompensation::ClampRewindTime(UWorld* World, float ClientTime)
+{
+	const float Now = World->GetTimeSeconds();
+	const float MaxRewind = FMath::Max(CVarLagCompensationMaxRewind.GetValueOnGameThread(), 0.0f);
+
+	return FMath::Clamp(ClientTime, Now - MaxRewind, Now);
+}
+
+float FMobaLagCompensation::GetBroadphaseSlack()
+{
+	return IsEnabled() ? FMath::Max(CVarLagCompensationSlack.GetValueOnGameThread(), 0.0f) : 0.0f;
+}
+
+bool FMobaLagCompensation::GetRewindCorrection(const ABattleMobaCharacter* Target, float RewindTime, FTransform& OutCorrection)
+{
+	if (!IsEnabled() || Target == nullptr || Target->GetMesh() == nullptr)
+	{
+		return false;
+	}
+
+	MOBA_SCOPE_CYCLE(STAT_MobaRewind);
+
+	FTransform PastTransform;
+	if (!Target->GetPoseHistory().Sample(RewindTime, PastTransform))
+	{
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_MobaRewindCount);
+	INC_FLOAT_STAT_BY(STAT_MobaRewindDepth, (Target->GetWorld()->GetTimeSeconds() - RewindTime) * 1000.0f);
+
+	//		world at RewindTime -> mesh space -> world now
+	PastTransform.RemoveScaling();
+	FTransform CurrentTransform = Target->GetMesh()->GetComponentTransform();
+	CurrentTransform.RemoveScaling();
+
+	OutCorrection = PastTransform.Inverse() * CurrentTransform;
+	return true;
+}
@@ -0,0 +1,375 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaLoadTest.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+#include "BattleMobaCharacter.h"
+#include "BattleMobaCTF.h"
+#include "MobaWorldRegistry.h"
+#include "MobaNetAccounting.h"
+
+//A flag walk gives up after this long, a bot stuck on geometry moves on to its next command
+static const float FlagWalkTimeout = 20.0f;
+
+static const float FlagReachedDistance = 300.0f;
+
+UMobaLoadTest* UMobaLoadTest::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UMobaLoadTest>() : nullptr;
+}
+
+void UMobaLoadTest::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	if (FParse::Param(CommandLine, TEXT("MobaBot")))
+	{
+		bBot = true;
+
+		int32 Seed = 0;
+		FParse::Value(CommandLine, TEXT("MobaBotSeed="), Seed);
+		Random.Initialize(Seed);
+
+		FString ScriptPath;
+		if (FParse::Value(CommandLine, TEXT("MobaBotScript="), ScriptPath))
+		{
+			bScripted = LoadScript(ScriptPath);
+		}
+	}
+
+	if (FParse::Value(CommandLine, TEXT("MobaBotRecord="), RecordPath))
+	{
+		SkillButtonHandle = ABattleMobaCharacter::OnSkillButton.AddUObject(this, &UMobaLoadTest::RecordSkill);
+	}
+
+	if (IsRunningDedicatedServer() && FParse::Value(CommandLine, TEXT("MobaLoadTest="), ExpectedPlayers) && ExpectedPlayers > 0)
+	{
+		FParse::Value(CommandLine, TEXT("MobaLoadTestSeconds="), CaptureSeconds);
+		ServerPhase = EServerPhase::WaitingForPlayers;
+
+		//		on from the start, so joining and initial replication are part of the bandwidth report
+		if (IConsoleVariable* Accounting = IConsoleManager::Get().FindConsoleVariable(TEXT("Moba.Net.Accounting")))
+		{
+			Accounting->Set(1);
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("Load test: waiting for %d players"), ExpectedPlayers);
+	}
+}
+
+void UMobaLoadTest::Deinitialize()
+{
+	ABattleMobaCharacter::OnSkillButton.Remove(SkillButtonHandle);
+
+	if (!RecordPath.IsEmpty() && (RecordLines.Num() > 0 || !RecordDirection.IsZero()))
+	{
+		FlushRecordedMove();
+		FFileHelper::SaveStringArrayToFile(RecordLines, *RecordPath);
+		UE_LOG(LogTemp, Display, TEXT("Load test: %d recorded inputs written to %s"), RecordLines.Num(), *RecordPath);
+	}
+
+	Super::Deinitialize();
+}
+
+ABattleMobaCharacter* UMobaLoadTest::GetLocalCharacter() const
+{
+	APlayerController* PC = GetGameInstance()->GetFirstLocalPlayerController();
+	return PC ? Cast<ABattleMobaCharacter>(PC->GetPawn()) : nullptr;
+}
+
+bool UMobaLoadTest::LoadScript(const FString& Path)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Load test: cannot read bot script %s, playing randomly"), *Path);
+		return false;
+	}
+
+	for (int32 LineIndex = 0; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		TArray<FString> Tokens;
+		Lines[LineIndex].ParseIntoArrayWS(Tokens);
+		if (Tokens.Num() == 0 || Tokens[0].StartsWith(TEXT("#")))
+		{
+			continue;
+		}
+
+		FCommand Command;
+		if (Tokens[0] == TEXT("move") && Tokens.Num() >= 4)
+		{
+			Command.Type = ECommand::Move;
+			Command.Direction = FVector2D(FCString::Atof(*Tokens[1]), FCString::Atof(*Tokens[2]));
+			Command.Duration = FCString::Atof(*Tokens[3]);
+		}
+		else if (Tokens[0] == TEXT("wait") && Tokens.Num() >= 2)
+		{
+			Command.Type = ECommand::Wait;
+			Command.Duration = FCString::Atof(*Tokens[1]);
+		}
+		else if (Tokens[0] == TEXT("skill") && Tokens.Num() >= 3)
+		{
+			Command.Type = ECommand::Skill;
+			Command.Key = FKey(FName(*Tokens[1]));
+			Command.Button = Tokens[2] == TEXT("-") ? FString() : Tokens[2];
+		}
+		else if (Tokens[0] == TEXT("flag") && Tokens.Num() >= 2)
+		{
+			Command.Type = ECommand::Flag;
+			Command.Flag = FCString::Atoi(*Tokens[1]);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Load test: %s:%d not understood: %s"), *Path, LineIndex + 1, *Lines[LineIndex]);
+			continue;
+		}
+		Commands.Add(Command);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Load test: %d bot commands loaded from %s"), Commands.Num(), *Path);
+	return Commands.Num() > 0;
+}
+
+void UMobaLoadTest::AddRandomCommands(const ABattleMobaCharacter* Character)
+{
+	UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(Character);
+	const int32 NumFlags = Registry ? Registry->GetAll<ABattleMobaCTF>().Num() : 0;
+	const FMobaSkillIndex& Skills = Character->GetSkillIndex();
+
+	if (NumFlags > 0)
+	{
+		FCommand& Walk = Commands.AddDefaulted_GetRef();
+		Walk.Type = ECommand::Flag;
+		Walk.Flag = Random.RandRange(0, NumFlags - 1);
+	}
+
+	for (int32 i = 0; i < 3; ++i)
+	{
+		FCommand& Move = Commands.AddDefaulted_GetRef();
+		Move.Type = ECommand::Move;
+		Move.Direction = FVector2D(Random.GetUnitVector()).GetSafeNormal();
+		Move.Duration = Random.FRandRange(1.0f, 3.0f);
+
+		if (const FActionSkill* Skill = Skills.Num() > 0 ? Skills.GetSkill(Random.RandRange(0, Skills.Num() - 1)) : nullptr)
+		{
+			FCommand& Press = Commands.AddDefaulted_GetRef();
+			Press.Type = ECommand::Skill;
+			Press.Key = Skill->keys;
+			Press.Button = Skill->ButtonName;
+
+			FCommand& Wait = Commands.AddDefaulted_GetRef();
+			Wait.Type = ECommand::Wait;
+			Wait.Duration = Random.FRandRange(0.5f, 1.5f);
+		}
+	}
+}
+
+void UMobaLoadTest::Tick(float DeltaTime)
+{
+	if (ServerPhase != EServerPhase::Off)
+	{
+		TickServer();
+	}
+	if (bBot)
+	{
+		TickBot(DeltaTime);
+	}
+	if (!RecordPath.IsEmpty())
+	{
+		TickRecord(DeltaTime);
+	}
+}
+
+void UMobaLoadTest::TickBot(float DeltaTime)
+{
+	ABattleMobaCharacter* Character = GetLocalCharacter();
+	if (Character == nullptr)
+	{
+		return;
+	}
+
+	if (!Commands.IsValidIndex(Cursor))
+	{
+		Cursor = 0;
+		if (!bScripted)
+		{
+			Commands.Reset();
+			AddRandomCommands(Character);
+		}
+	}
+
+	const FCommand& Command = Commands[Cursor];
+	CommandTime += DeltaTime;
+
+	bool bDone = true;
+	switch (Command.Type)
+	{
+	case ECommand::Move:
+		Character->AddMovementInput(FVector(Command.Direction, 0.0f));
+		bDone = CommandTime >= Command.Duration;
+		break;
+
+	case ECommand::Wait:
+		bDone = CommandTime >= Command.Duration;
+		break;
+
+	case ECommand::Skill:
+	{
+		bool bCooldown = false;
+		float CooldownVal = 0.0f;
+		Character->GetButtonSkillAction(Command.Key, Command.Button, bCooldown, CooldownVal);
+		break;
+	}
+
+	case ECommand::Flag:
+	{
+		UMobaWorldRegistry* Registry = UMobaWorldRegistry::Get(Character);
+		const TArray<ABattleMobaCTF*>* Flags = Registry ? &Registry->GetAll<ABattleMobaCTF>() : nullptr;
+		if (Flags && Flags->Num() > 0 && CommandTime < FlagWalkTimeout)
+		{
+			const FVector ToFlag = (*Flags)[Command.Flag % Flags->Num()]->GetActorLocation() - Character->GetActorLocation();
+			bDone = ToFlag.Size2D() < FlagReachedDistance;
+			if (!bDone)
+			{
+				Character->AddMovementInput(ToFlag.GetSafeNormal2D());
+			}
+		}
+		break;
+	}
+	}
+
+	if (bDone)
+	{
+		++Cursor;
+		CommandTime = 0.0f;
+	}
+}
+
+void UMobaLoadTest::RecordSkill(ABattleMobaCharacter* Character, const FKey& Key, const FString& ButtonName)
+{
+	if (RecordPath.IsEmpty() || Character != GetLocalCharacter())
+	{
+		return;
+	}
+
+	FlushRecordedMove();
+	RecordLines.Add(FString::Printf(TEXT("skill %s %s"), *Key.GetFName().ToString(), ButtonName.IsEmpty() ? TEXT("-") : *ButtonName));
+}
+
+void UMobaLoadTest::TickRecord(float DeltaTime)
+{
+	ABattleMobaCharacter* Character = GetLocalCharacter();
+	if (Character == nullptr)
+	{
+		return;
+	}
+	RecordTime += DeltaTime;
+
+	//		rounded so small stick wobble does not turn into a line per frame
+	const FVector Input = Character->GetLastMovementInputVector();
+	const FVector2D Direction(FMath::RoundToFloat(Input.X * 10.0f) / 10.0f, FMath::RoundToFloat(Input.Y * 10.0f) / 10.0f);
+	if (!Direction.Equals(RecordDirection, KINDA_SMALL_NUMBER))
+	{
+		FlushRecordedMove();
+		RecordDirection = Direction;
+	}
+}
+
+void UMobaLoadTest::FlushRecordedMove()
+{
+	const float Duration = RecordTime - RecordSince;
+	if (Duration > 0.0f)
+	{
+		RecordLines.Add(RecordDirection.IsZero()
+			? FString::Printf(TEXT("wait %.2f"), Duration)
+			: FString::Printf(TEXT("move %.1f %.1f %.2f"), RecordDirection.X, RecordDirection.Y, Duration));
+	}
+	RecordSince = RecordTime;
+}
+
+void UMobaLoadTest::TickServer()
+{
+	UWorld* World = GetGameInstance()->GetWorld();
+	AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+	const double Now = FPlatformTime::Seconds();
+
+	switch (ServerPhase)
+	{
+	case EServerPhase::WaitingForPlayers:
+		if (GameMode && GameMode->GetNumPlayers() >= ExpectedPlayers)
+		{
+#if CSV_PROFILER
+			FCsvProfiler::Get()->BeginCapture();
+#endif
+			PhaseEndTime = Now + CaptureSeconds;
+			ServerPhase = EServerPhase::Capturing;
+			UE_LOG(LogTemp, Display, TEXT("Load test: %d players in, capturing %.0f seconds"), GameMode->GetNumPlayers(), CaptureSeconds);
+		}
+		break;
+
+	case EServerPhase::Capturing:
+		if (Now >= PhaseEndTime)
+		{
+#if CSV_PROFILER
+			FCsvProfiler::Get()->EndCapture();
+#endif
+			if (UMobaNetAccounting* Accounting = UMobaNetAccounting::Get(World))
+			{
+				Accounting->WriteReport(FPaths::Combine(FPaths::ProjectLogDir(), FString::Printf(TEXT("NetAccounting-%d.csv"), ExpectedPlayers)));
+			}
+
+			//		the CSV file is finished on the frames after EndCapture
+			PhaseEndTime = Now + 5.0;
+			ServerPhase = EServerPhase::Exiting;
+		}
+		break;
+
+	case EServerPhase::Exiting:
+#if CSV_PROFILER
+		if (FCsvProfiler::Get()->IsCapturing())
+		{
+			break;
+		}
+#endif
+		if (Now >= PhaseEndTime)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Load test: done"));
+			ServerPhase = EServerPhase::Off;
+			FPlatformMisc::RequestExit(false);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+bool UMobaLoadTest::IsTickable() const
+{
+	return !IsTemplate() && (bBot || !RecordPath.IsEmpty() || ServerPhase != EServerPhase::Off);
+}
+
+ETickableTickType UMobaLoadTest::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UMobaLoadTest::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMobaLoadTest, STATGROUP_Tickables);
+}
@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaNameplateOcclusion.h"
+#include "Engine/World.h"
+#include "Components/WidgetComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+
+#include "BattleMoba.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaNameplateOcclusion, "Nameplate Occlusion");
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nameplate Traces"), STAT_MobaNameplateTraces, STATGROUP_BattleMoba);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Nameplates Tracked"), STAT_MobaNameplatesTracked, STATGROUP_BattleMoba);
+
+static TAutoConsoleVariable<int32> CVarMobaNameplateTracesPerFrame(
+	TEXT("Moba.Nameplate.TracesPerFrame"),
+	4,
+	TEXT("Most nameplate occlusion sweeps issued per frame."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMobaNameplateHysteresis(
+	TEXT("Moba.Nameplate.Hysteresis"),
+	2,
+	TEXT("Sweep results in a row that must agree before a nameplate is shown or hidden."),
+	ECVF_Default);
+
+bool UMobaNameplateOcclusion::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UMobaNameplateOcclusion::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TraceDelegate.BindUObject(this, &UMobaNameplateOcclusion::OnTraceDone);
+}
+
+void UMobaNameplateOcclusion::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_MobaNameplatesTracked, Nameplates.Num());
+	Nameplates.Reset();
+	TraceDelegate.Unbind();
+
+	Super::Deinitialize();
+}
+
+void UMobaNameplateOcclusion::Track(UWidgetComponent* Widget, AActor* Owner)
+{
+	if (Widget == nullptr || FindSerial(Widget) != 0)
+	{
+		return;
+	}
+
+	FNameplate& Nameplate = Nameplates.Add(NextSerial++);
+	Nameplate.Widget = Widget;
+	Nameplate.Owner = Owner;
+
+	//		checked in the next frame so a nameplate entering view does not wait its turn
+	Nameplate.Urgency = BIG_NUMBER;
+
+	INC_DWORD_STAT(STAT_MobaNameplatesTracked);
+}
+
+void UMobaNameplateOcclusion::Untrack(UWidgetComponent* Widget)
+{
+	const uint32 Serial = FindSerial(Widget);
+	if (Serial != 0)
+	{
+		//		a sweep still in flight finds no entry and is dropped
+		Nameplates.Remove(Serial);
+		DEC_DWORD_STAT(STAT_MobaNameplatesTracked);
+	}
+}
+
+void UMobaNameplateOcclusion::Refresh(UWidgetComponent* Widget)
+{
+	if (FNameplate* Nameplate = Nameplates.Find(FindSerial(Widget)))
+	{
+		Nameplate->Urgency = BIG_NUMBER;
+	}
+}
+
+uint32 UMobaNameplateOcclusion::FindSerial(const UWidgetComponent* Widget) const
+{
+	for (const TPair<uint32, FNameplate>& Pair : Nameplates)
+	{
+		if (Pair.Value.Widget.Get() == Widget)
+		{
+			return Pair.Key;
+		}
+	}
+	return 0;
+}
+
+void UMobaNameplateOcclusion::Tick(float DeltaTime)
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaNameplateOcclusion);
+
+	APlayerCameraManager* Camera = UGameplayStatics::GetPlayerCameraManager(this, 0);
+	if (Camera == nullptr)
+	{
+		return;
+	}
+
+	const FVector CameraLocation = Camera->GetCameraLocation();
+	const FVector CameraForward = Camera->GetCameraRotation().Vector();
+
+	TArray<TPair<float, uint32>, TInlineAllocator<32>> Candidates;
+	for (auto It = Nameplates.CreateIterator(); It; ++It)
+	{
+		FNameplate& Nameplate = It.Value();
+		UWidgetComponent* Widget = Nameplate.Widget.Get();
+		if (Widget == nullptr)
+		{
+			It.RemoveCurrent();
+			DEC_DWORD_STAT(STAT_MobaNameplatesTracked);
+			continue;
+		}
+
+		const FVector ToWidget = Widget->GetComponentLocation() - CameraLocation;
+		if (Nameplate.bPending || FVector::DotProduct(ToWidget, CameraForward) <= 0.0f)
+		{
+			continue;
+		}
+
+		//		rough projected height, near and large nameplates flicker most visibly so they come up more often
+		const float ScreenSize = FMath::Max(Widget->GetCurrentDrawSize().Y, 1.0f) / FMath::Max(ToWidget.Size(), 100.0f);
+		Nameplate.Urgency = FMath::Min(Nameplate.Urgency + ScreenSize * DeltaTime, BIG_NUMBER);
+		Candidates.Emplace(Nameplate.Urgency, It.Key());
+	}
+
+	const int32 Budget = FMath::Min(CVarMobaNameplateTracesPerFrame.GetValueOnGameThread(), Candidates.Num());
+	if (Budget <= 0)
+	{
+		return;
+	}
+
+	Candidates.Sort([](const TPair<float, uint32>& A, const TPair<float, uint32>& B) { return A.Key > B.Key; });
+
+	for (int32 i = 0; i < Budget; ++i)
+	{
+		const uint32 Serial = Candidates[i].Value;
+		FNameplate& Nameplate = Nameplates[Serial];
+		UWidgetComponent* Widget = Nameplate.Widget.Get();
+
+		//		same box the per-character sweep used, scaled from the widget's draw size
+		const FVector2D DrawSize = Widget->GetCurrentDrawSize();
+		const FCollisionShape Box = FCollisionShape::MakeBox(FVector(DrawSize.X / 10.0f, DrawSize.Y / 10.0f, (DrawSize.Y / 10.0f) / 4.0f));
+
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(MobaNameplateOcclusion), false, Nameplate.Owner.Get());
+
+		GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, Widget->GetComponentLocation(), CameraLocation, FQuat::Identity, ECC_Visibility, Box, Params, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, Serial);
+
+		Nameplate.bPending = true;
+		INC_DWORD_STAT(STAT_MobaNameplateTraces);
+	}
+}
+
+void UMobaNameplateOcclusion::OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	FNameplate* Nameplate = Nameplates.Find(Datum.UserData);
+	if (Nameplate == nullptr)
+	{
+		return;
+	}
+
+	Nameplate->bPending = false;
+	Nameplate->Urgency = 0.0f;
+
+	UWidgetComponent* Widget = Nameplate->Widget.Get();
+	if (Widget == nullptr)
+	{
+		return;
+	}
+
+	bool bOccluded = false;
+	for (const FHitResult& Hit : Datum.OutHits)
+	{
+		bOccluded |= Hit.bBlockingHit;
+	}
+
+	if (bOccluded != Widget->IsVisible())
+	{
+		Nameplate->Streak = 0;
+		return;
+	}
+
+	if (++Nameplate->Streak >= CVarMobaNameplateHysteresis.GetValueOnGameThread())
+	{
+		Nameplate->Streak = 0;
+		Widget->SetVisibility(!bOccluded);
+	}
+}
+
+bool UMobaNameplateOcclusion::IsTickable() const
+{
+	return !IsTemplate() && Nameplates.Num() > 0;
+}
+
+ETickableTickType UMobaNameplateOcclusion::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UMobaNameplateOcclusion::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMobaNameplateOcclusion, STATGROUP_Tickables);
+}
@@ -0,0 +1,384 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaNetAccounting.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/UnrealType.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "BattleMoba.h"
+#include "MobaNetProfiling.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaNetAccounting, "Net Accounting");
+
+static TAutoConsoleVariable<int32> CVarMobaNetAccounting(
+	TEXT("Moba.Net.Accounting"),
+	0,
+	TEXT("Sum the estimated size of every RPC and replicated property per connection, written out as a CSV at match end."),
+	ECVF_Default);
+
+/**		Whether a property with Condition goes out on a connection, ignoring custom active overrides*/
+static bool SendsTo(ELifetimeCondition Condition, bool bInitial, bool bOwner)
+{
+	switch (Condition)
+	{
+	case COND_InitialOnly:
+		return bInitial;
+	case COND_InitialOrOwner:
+		return bInitial || bOwner;
+	case COND_OwnerOnly:
+	case COND_AutonomousOnly:
+	case COND_ReplayOrOwner:
+		return bOwner;
+	case COND_SkipOwner:
+	case COND_SimulatedOnly:
+	case COND_SimulatedOrPhysics:
+	case COND_SimulatedOnlyNoReplay:
+	case COND_SimulatedOrPhysicsNoReplay:
+		return !bOwner;
+	case COND_ReplayOnly:
+		return false;
+	default:
+		return true;
+	}
+}
+
+static bool IdenticalComplete(const UProperty* Property, const void* A, const void* B)
+{
+	for (int32 i = 0; i < Property->ArrayDim; ++i)
+	{
+		const int32 Offset = i * Property->ElementSize;
+		if (!Property->Identical(static_cast<const uint8*>(A) + Offset, static_cast<const uint8*>(B) + Offset))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+UMobaNetAccounting* UMobaNetAccounting::Get(const UObject* WorldContextObject)
+{
+	if (CVarMobaNetAccounting.GetValueOnGameThread() == 0)
+	{
+		return nullptr;
+	}
+
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UMobaNetAccounting>() : nullptr;
+}
+
+void UMobaNetAccounting::RecordRpcFor(AActor* Actor, UFunction* Function, void* Parameters)
+{
+	if (UMobaNetAccounting* Accounting = Get(Actor))
+	{
+		Accounting->RecordRpc(Actor, Function, Parameters);
+	}
+}
+
+void UMobaNetAccounting::RecordPropertiesFor(AActor* Actor)
+{
+	if (UMobaNetAccounting* Accounting = Get(Actor))
+	{
+		Accounting->RecordProperties(Actor);
+	}
+}
+
+void UMobaNetAccounting::Deinitialize()
+{
+	//		clients and matches that never finished still leave a report behind
+	if (!bReportWritten && Rows.Num() > 0)
+	{
+		const FString Path = WriteReport();
+		UE_LOG(LogTemp, Display, TEXT("Net accounting written to %s"), *Path);
+	}
+
+	for (TPair<TObjectKey<AActor>, FShadow>& Pair : Shadows)
+	{
+		FreeShadow(Pair.Value);
+	}
+	Shadows.Reset();
+	Layouts.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMobaNetAccounting::RecordRpc(AActor* Actor, UFunction* Function, void* Parameters)
+{
+	UNetDriver* Driver = Actor ? Actor->GetNetDriver() : nullptr;
+	if (Driver == nullptr || Function == nullptr)
+	{
+		return;
+	}
+
+	MOBA_SCOPE_CYCLE(STAT_MobaNetAccounting);
+
+	const int64 Bits = FMobaNetSizeEstimator::EstimateFunctionBits(Function, Parameters);
+	const bool bReliable = Function->HasAnyFunctionFlags(FUNC_NetReliable);
+	const FName Owner = Function->GetOwnerClass()->GetFName();
+
+	if (Function->HasAnyFunctionFlags(FUNC_NetMulticast))
+	{
+		//		a multicast only reaches the connections the actor is relevant to
+		for (UNetConnection* Connection : Driver->ClientConnections)
+		{
+			if (Connection && Connection->FindActorChannelRef(Actor))
+			{
+				Charge(Connection, Owner, Function->GetFName(), true, bReliable, Bits);
+			}
+		}
+	}
+	else if (UNetConnection* Connection = Actor->GetNetConnection())
+	{
+		Charge(Connection, Owner, Function->GetFName(), true, bReliable, Bits);
+	}
+}
+
+void UMobaNetAccounting::RecordProperties(AActor* Actor)
+{
+	UNetDriver* Driver = Actor ? Actor->GetNetDriver() : nullptr;
+	if (Driver == nullptr || !Actor->HasAuthority())
+	{
+		return;
+	}
+
+	MOBA_SCOPE_CYCLE(STAT_MobaNetAccounting);
+
+	const UObject* Defaults = Actor->GetArchetype();
+
+	FShadow& Shadow = Shadows.FindOrAdd(Actor);
+	if (Shadow.Data == nullptr)
+	{
+		//		the shadow starts at the defaults, so the first update charges what differs from them
+		Shadow.Layout = &GetLayout(Actor->GetClass());
+		Shadow.Data = static_cast<uint8*>(FMemory::Malloc(FMath::Max(Shadow.Layout->Size, 1), Shadow.Layout->Alignment));
+		for (const FTrackedProperty& Tracked : Shadow.Layout->Properties)
+		{
+			Tracked.Property->InitializeValue(Shadow.Data + Tracked.Offset);
+			Tracked.Property->CopyCompleteValue(Shadow.Data + Tracked.Offset, Tracked.Property->ContainerPtrToValuePtr<void>(Defaults));
+		}
+
+		Actor->OnEndPlay.AddUniqueDynamic(this, &UMobaNetAccounting::OnActorEndPlay);
+	}
+
+	const TArray<FTrackedProperty>& Properties = Shadow.Layout->Properties;
+
+	//		size of each property is only estimated when some connection is charged for it
+	TArray<int64, TInlineAllocator<64>> Bits;
+	Bits.Init(-1, Properties.Num());
+
+	TArray<bool, TInlineAllocator<64>> Changed;
+	Changed.SetNumUninitialized(Properties.Num());
+	for (int32 i = 0; i < Properties.Num(); ++i)
+	{
+		const FTrackedProperty& Tracked = Properties[i];
+		Changed[i] = !IdenticalComplete(Tracked.Property, Tracked.Property->ContainerPtrToValuePtr<void>(Actor), Shadow.Data + Tracked.Offset);
+	}
+
+	UNetConnection* OwnerConnection = Actor->GetNetConnection();
+	TArray<TObjectKey<UNetConnection>> Channels;
+
+	for (UNetConnection* Connection : Driver->ClientConnections)
+	{
+		if (Connection == nullptr || !Connection->FindActorChannelRef(Actor))
+		{
+			continue;
+		}
+		Channels.Add(Connection);
+
+		//		a channel opened since the last update got everything that differs from the defaults, one update late
+		const bool bInitial = !Shadow.Channels.Contains(TObjectKey<UNetConnection>(Connection));
+		const bool bOwner = Connection == OwnerConnection;
+
+		for (int32 i = 0; i < Properties.Num(); ++i)
+		{
+			const FTrackedProperty& Tracked = Properties[i];
+			if (!SendsTo(Tracked.Condition, bInitial, bOwner))
+			{
+				continue;
+			}
+
+			const void* Value = Tracked.Property->ContainerPtrToValuePtr<void>(Actor);
+			const bool bSent = bInitial ? !IdenticalComplete(Tracked.Property, Value, Tracked.Property->ContainerPtrToValuePtr<void>(Defaults)) : Changed[i];
+			if (!bSent)
+			{
+				continue;
+			}
+
+			if (Bits[i] < 0)
+			{
+				Bits[i] = FMobaNetSizeEstimator::EstimatePropertyBits(Tracked.Property, Value);
+			}
+			Charge(Connection, Tracked.Property->GetOwnerClass()->GetFName(), Tracked.Property->GetFName(), false, true, Bits[i]);
+		}
+	}
+
+	for (int32 i = 0; i < Properties.Num(); ++i)
+	{
+		if (Changed[i])
+		{
+			const FTrackedProperty& Tracked = Properties[i];
+			Tracked.Property->CopyCompleteValue(Shadow.Data + Tracked.Offset, Tracked.Property->ContainerPtrToValuePtr<void>(Actor));
+		}
+	}
+	Shadow.Channels = MoveTemp(Channels);
+}
+
+FString UMobaNetAccounting::WriteReport(const FString& Filename)
+{
+	bReportWritten = true;
+
+	//		connections still open may have a player name by now
+	for (const TPair<TObjectKey<UNetConnection>, int32>& Pair : ConnectionIndices)
+	{
+		UNetConnection* Connection = Pair.Key.ResolveObjectPtr();
+		if (Connection && Connection->PlayerController && Connection->PlayerController->PlayerState)
+		{
+			ConnectionNames[Pair.Value] = FString::Printf(TEXT("%s %s"), *Connection->PlayerController->PlayerState->GetPlayerName(), *Connection->LowLevelGetRemoteAddress(true));
+		}
+	}
+
+	TArray<TPair<FRowKey, FRow>> Sorted = Rows.Array();
+	Sorted.Sort([](const TPair<FRowKey, FRow>& A, const TPair<FRowKey, FRow>& B) { return A.Value.Bits > B.Value.Bits; });
+
+	TArray<FString> Lines;
+	Lines.Reserve(Sorted.Num() + 1);
+	Lines.Add(TEXT("Connection,Class,Member,Kind,Reliability,Count,Bytes,BytesPerCount"));
+
+	int64 TotalBits = 0;
+	for (const TPair<FRowKey, FRow>& Pair : Sorted)
+	{
+		const FRow& Row = Pair.Value;
+		const double Bytes = double(Row.Bits) / 8.0;
+		Lines.Add(FString::Printf(TEXT("\"%s\",%s,%s,%s,%s,%lld,%.0f,%.1f"),
+			*ConnectionNames[Pair.Key.Connection],
+			*Pair.Key.Owner.ToString(),
+			*Pair.Key.Member.ToString(),
+			Row.bRpc ? TEXT("RPC") : TEXT("Property"),
+			Row.bRpc ? (Row.bReliable ? TEXT("Reliable") : TEXT("Unreliable")) : TEXT("Resent"),
+			Row.Count,
+			Bytes,
+			Row.Count > 0 ? Bytes / double(Row.Count) : 0.0));
+
+		TotalBits += Row.Bits;
+	}
+
+	const FString Path = Filename.IsEmpty()
+		? FPaths::Combine(FPaths::ProjectLogDir(), FString::Printf(TEXT("NetAccounting-%s.csv"), *FDateTime::Now().ToString()))
+		: Filename;
+
+	FFileHelper::SaveStringArrayToFile(Lines, *Path);
+
+	UE_LOG(LogTemp, Display, TEXT("Net accounting: %d rows over %d connections, %lld bytes estimated"), Sorted.Num(), ConnectionNames.Num(), TotalBits / 8);
+	return Path;
+}
+
+const UMobaNetAccounting::FClassLayout& UMobaNetAccounting::GetLayout(const UClass* Class)
+{
+	TUniquePtr<FClassLayout>& Layout = Layouts.FindOrAdd(Class);
+	if (Layout.IsValid())
+	{
+		return *Layout;
+	}
+
+	Layout = MakeUnique<FClassLayout>();
+
+	TArray<FLifetimeProperty> Lifetime;
+	Class->GetDefaultObject()->GetLifetimeReplicatedProps(Lifetime);
+
+	for (const FLifetimeProperty& Entry : Lifetime)
+	{
+		if (!Class->ClassReps.IsValidIndex(Entry.RepIndex))
+		{
+			continue;
+		}
+
+		//		static arrays get one entry per element, the first one stands for the whole property
+		const FRepRecord& Record = Class->ClassReps[Entry.RepIndex];
+		if (Record.Index != 0)
+		{
+			continue;
+		}
+
+		const int32 Alignment = Record.Property->GetMinAlignment();
+
+		FTrackedProperty& Tracked = Layout->Properties.AddDefaulted_GetRef();
+		Tracked.Property = Record.Property;
+		Tracked.Condition = Entry.Condition;
+		Tracked.Offset = Align(Layout->Size, Alignment);
+
+		Layout->Size = Tracked.Offset + Record.Property->GetSize();
+		Layout->Alignment = FMath::Max(Layout->Alignment, Alignment);
+	}
+
+	return *Layout;
+}
+
+int32 UMobaNetAccounting::GetConnectionIndex(UNetConnection* Connection)
+{
+	if (const int32* Index = ConnectionIndices.Find(Connection))
+	{
+		return *Index;
+	}
+
+	const int32 Index = ConnectionNames.Add(Connection == Connection->Driver->ServerConnection ? FString(TEXT("Server")) : Connection->LowLevelGetRemoteAddress(true));
+	ConnectionIndices.Add(Connection, Index);
+	return Index;
+}
+
+void UMobaNetAccounting::Charge(UNetConnection* Connection, FName Owner, FName Member, bool bRpc, bool bReliable, int64 Bits)
+{
+	FRow& Row = Rows.FindOrAdd(FRowKey{ GetConnectionIndex(Connection), Owner, Member });
+	Row.bRpc = bRpc;
+	Row.bReliable = bReliable;
+	Row.Count += 1;
+	Row.Bits += Bits;
+}
+
+void UMobaNetAccounting::FreeShadow(FShadow& Shadow)
+{
+	if (Shadow.Data == nullptr)
+	{
+		return;
+	}
+
+	for (const FTrackedProperty& Tracked : Shadow.Layout->Properties)
+	{
+		Tracked.Property->DestroyValue(Shadow.Data + Tracked.Offset);
+	}
+	FMemory::Free(Shadow.Data);
+	Shadow.Data = nullptr;
+}
+
+void UMobaNetAccounting::OnActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	FShadow Shadow;
+	if (Shadows.RemoveAndCopyValue(Actor, Shadow))
+	{
+		FreeShadow(Shadow);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs MobaNetAccountingReportCommand(
+	TEXT("Moba.Net.AccountingReport"),
+	TEXT("Write the net accounting totals so far. Optional argument: the file name, a timestamped file in the log directory otherwise."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UMobaNetAccounting* Accounting = World ? World->GetSubsystem<UMobaNetAccounting>() : nullptr;
+		if (Accounting == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Moba.Net.AccountingReport: no accounting in this world"));
+			return;
+		}
+
+		const FString Path = Accounting->WriteReport(Args.Num() > 0 ? Args[0] : FString());
+		UE_LOG(LogTemp, Log, TEXT("Moba.Net.AccountingReport: written to %s"), *Path);
+	}));
@@ -0,0 +1,150 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaNetProfiling.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "Serialization/BitWriter.h"
+#include "UObject/UnrealType.h"
+#include "HAL/IConsoleManager.h"
+
+#include "BattleMobaCharacter.h"
+#include "MobaSkillIndex.h"
+
+int64 FMobaNetSizeEstimator::EstimatePropertyBits(const UProperty* Property, const void* ValuePtr)
+{
+	int64 Bits = 0;
+
+	for (int32 i = 0; i < Property->ArrayDim; ++i)
+	{
+		const uint8* ElementPtr = static_cast<const uint8*>(ValuePtr) + i * Property->ElementSize;
+
+		if (const UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+		{
+			Bits += EstimateStructBits(StructProperty->Struct, ElementPtr);
+		}
+		else if (Cast<UObjectPropertyBase>(Property))
+		{
+			Bits += ObjectReferenceBits;
+		}
+		else if (const UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+		{
+			FScriptArrayHelper Helper(ArrayProperty, ElementPtr);
+
+			//		array count, as written by the rep layout
+			Bits += 16;
+			for (int32 Index = 0; Index < Helper.Num(); ++Index)
+			{
+				Bits += EstimatePropertyBits(ArrayProperty->Inner, Helper.GetRawPtr(Index));
+			}
+		}
+		else
+		{
+			FNetBitWriter Writer(0);
+			Property->NetSerializeItem(Writer, nullptr, const_cast<uint8*>(ElementPtr));
+			Bits += Writer.GetNumBits();
+		}
+	}
+
+	return Bits;
+}
+
+int64 FMobaNetSizeEstimator::EstimateStructBits(const UScriptStruct* Struct, const void* StructData)
+{
+	if (Struct->StructFlags & STRUCT_NetSerializeNative)
+	{
+		FNetBitWriter Writer(0);
+		bool bSuccess = true;
+		Struct->GetCppStructOps()->NetSerialize(Writer, nullptr, bSuccess, const_cast<void*>(StructData));
+		return Writer.GetNumBits();
+	}
+
+	int64 Bits = 0;
+	for (TFieldIterator<UProperty> It(Struct); It; ++It)
+	{
+		if (It->PropertyFlags & CPF_RepSkip)
+		{
+			continue;
+		}
+		Bits += EstimatePropertyBits(*It, It->ContainerPtrToValuePtr<void>(StructData));
+	}
+	return Bits;
+}
+
+int64 FMobaNetSizeEstimator::EstimateFunctionBits(const UFunction* Function, const void* Params)
+{
+	int64 Bits = 0;
+	for (TFieldIterator<UProperty> It(Function); It && (It->PropertyFlags & CPF_Parm); ++It)
+	{
+		//		every parameter but bools is preceded by a bit saying whether it was sent
+		if (!Cast<UBoolProperty>(*It))
+		{
+			Bits += 1;
+		}
+		Bits += EstimatePropertyBits(*It, It->ContainerPtrToValuePtr<void>(Params));
+	}
+	return Bits;
+}
+
+/**		Compares the skill RPC payload of every skill of the first character against the old FActionSkill payload*/
+static FAutoConsoleCommandWithWorldAndArgs MobaSkillRpcPayloadCommand(
+	TEXT("Moba.Net.SkillRpcPayload"),
+	TEXT("Log the estimated ServerExecuteAction payload per skill, by value FActionSkill against skill and section indices."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		TActorIterator<ABattleMobaCharacter> It(World);
+		if (!It)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Moba.Net.SkillRpcPayload: no character in the world"));
+			return;
+		}
+
+		ABattleMobaCharacter* Character = *It;
+		const FMobaSkillIndex& Skills = Character->GetSkillIndex();
+
+		UFunction* Function = Character->FindFunction(TEXT("ServerExecuteAction"));
+		if (Function == nullptr || Skills.Num() == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Moba.Net.SkillRpcPayload: %s has no skills loaded"), *Character->GetName());
+			return;
+		}
+
+		uint8* Params = static_cast<uint8*>(FMemory_Alloca(Function->ParmsSize));
+		FMemory::Memzero(Params, Function->ParmsSize);
+		Function->InitializeStruct(Params);
+
+		int64 OldTotal = 0;
+		int64 NewTotal = 0;
+
+		for (int32 SkillId = 0; SkillId < Skills.Num(); ++SkillId)
+		{
+			//		the old RPC sent the whole row, the section name and the special attack flag
+			FName Section = TEXT("NormalAttack01");
+			FNetBitWriter SectionWriter(0);
+			SectionWriter << Section;
+			const int64 OldBits = 1 + FMobaNetSizeEstimator::EstimateStructBits(FActionSkill::StaticStruct(), Skills.GetSkill(SkillId)) + 1 + SectionWriter.GetNumBits() + 1;
+
+			if (UByteProperty* SkillProperty = Cast<UByteProperty>(Function->FindPropertyByName(TEXT("SkillId"))))
+			{
+				SkillProperty->SetPropertyValue_InContainer(Params, uint8(SkillId));
+			}
+			const int64 NewBits = FMobaNetSizeEstimator::EstimateFunctionBits(Function, Params);
+
+			OldTotal += OldBits;
+			NewTotal += NewBits;
+
+			UE_LOG(LogTemp, Display, TEXT("%-24s FActionSkill: %5lld bits  indices: %3lld bits"), *Skills.GetRowName(SkillId).ToString(), OldBits, NewBits);
+		}
+
+		Function->DestroyStruct(Params);
+
+		const FString Summary = FString::Printf(TEXT("Skill RPC payload over %d skills: %lld bits by value, %lld bits by index (%.1fx smaller)"),
+			Skills.Num(), OldTotal, NewTotal, NewTotal > 0 ? double(OldTotal) / double(NewTotal) : 0.0);
+
+		UE_LOG(LogTemp, Display, TEXT("%s"), *Summary);
+		if (GEngine)
+		{
+			GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Cyan, Summary);
+		}
+	}));
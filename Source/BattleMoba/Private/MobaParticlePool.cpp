@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaParticlePool.h"
+#include "Engine/World.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+
+#include "BattleMoba.h"
+#include "MobaSkillIndex.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Particle Pool Hits"), STAT_MobaParticlePoolHits, STATGROUP_BattleMoba);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Particle Pool Misses"), STAT_MobaParticlePoolMisses, STATGROUP_BattleMoba);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Particle Pool Recycled"), STAT_MobaParticlePoolRecycled, STATGROUP_BattleMoba);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Particle Pool Components"), STAT_MobaParticlePoolComponents, STATGROUP_BattleMoba);
+
+static TAutoConsoleVariable<int32> CVarMobaParticlePoolMax(
+	TEXT("Moba.ParticlePool.MaxPerSystem"),
+	8,
+	TEXT("Most pooled components per particle system, the oldest one is restarted past this."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMobaParticlePoolPrewarm(
+	TEXT("Moba.ParticlePool.Prewarm"),
+	2,
+	TEXT("Components created per hit impact when a skill table is loaded."),
+	ECVF_Default);
+
+bool UMobaParticlePool::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UMobaParticlePool::Deinitialize()
+{
+	for (TPair<UParticleSystem*, FMobaParticlePoolEntry>& Pool : Pools)
+	{
+		for (UParticleSystemComponent* Component : Pool.Value.Components)
+		{
+			if (Component != nullptr)
+			{
+				Component->DestroyComponent();
+			}
+		}
+		DEC_DWORD_STAT_BY(STAT_MobaParticlePoolComponents, Pool.Value.Components.Num());
+	}
+	Pools.Reset();
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UMobaParticlePool::CreateComponent(UParticleSystem* Template, FMobaParticlePoolEntry& Entry)
+{
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(GetWorld());
+	Component->bAutoDestroy = false;
+	Component->bAutoActivate = false;
+	Component->SetAbsolute(true, true, true);
+	Component->SetTemplate(Template);
+	Component->RegisterComponentWithWorld(GetWorld());
+
+	Entry.Components.Add(Component);
+	Entry.ActivatedAt.Add(0.0f);
+
+	INC_DWORD_STAT(STAT_MobaParticlePoolComponents);
+	return Component;
+}
+
+UParticleSystemComponent* UMobaParticlePool::Spawn(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	if (Template == nullptr)
+	{
+		return nullptr;
+	}
+
+	FMobaParticlePoolEntry& Entry = Pools.FindOrAdd(Template);
+
+	//		finished component first, otherwise the one activated longest ago
+	int32 Index = INDEX_NONE;
+	int32 Oldest = INDEX_NONE;
+	for (int32 i = 0; i < Entry.Components.Num(); ++i)
+	{
+		UParticleSystemComponent* Component = Entry.Components[i];
+		if (Component == nullptr || Component->IsPendingKill())
+		{
+			continue;
+		}
+		if (!Component->IsActive())
+		{
+			Index = i;
+			break;
+		}
+		if (Oldest == INDEX_NONE || Entry.ActivatedAt[i] < Entry.ActivatedAt[Oldest])
+		{
+			Oldest = i;
+		}
+	}
+
+	if (Index != INDEX_NONE)
+	{
+		INC_DWORD_STAT(STAT_MobaParticlePoolHits);
+	}
+	else if (Entry.Components.Num() < FMath::Max(1, CVarMobaParticlePoolMax.GetValueOnGameThread()) || Oldest == INDEX_NONE)
+	{
+		INC_DWORD_STAT(STAT_MobaParticlePoolMisses);
+		CreateComponent(Template, Entry);
+		Index = Entry.Components.Num() - 1;
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_MobaParticlePoolRecycled);
+		Index = Oldest;
+	}
+
+	UParticleSystemComponent* Component = Entry.Components[Index];
+	Entry.ActivatedAt[Index] = GetWorld()->GetTimeSeconds();
+
+	Component->SetWorldLocationAndRotation(Location, Rotation);
+	Component->ActivateSystem(true);
+	return Component;
+}
+
+void UMobaParticlePool::Prewarm(UParticleSystem* Template, int32 Count)
+{
+	if (Template == nullptr)
+	{
+		return;
+	}
+
+	FMobaParticlePoolEntry& Entry = Pools.FindOrAdd(Template);
+
+	const int32 Target = FMath::Min(Count, CVarMobaParticlePoolMax.GetValueOnGameThread());
+	while (Entry.Components.Num() < Target)
+	{
+		CreateComponent(Template, Entry);
+	}
+}
+
+void UMobaParticlePool::PrewarmSkills(const FMobaSkillIndex& Skills)
+{
+	const int32 Count = CVarMobaParticlePoolPrewarm.GetValueOnGameThread();
+
+	for (int32 SkillIndex = 0; SkillIndex < Skills.Num(); ++SkillIndex)
+	{
+		if (const FActionSkill* Skill = Skills.GetSkill(SkillIndex))
+		{
+			Prewarm(Skill->HitImpact, Count);
+		}
+	}
+}
+
+UParticleSystemComponent* UMobaParticlePool::SpawnEmitter(UWorld* World, UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	if (World == nullptr || Template == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (UMobaParticlePool* Pool = World->GetSubsystem<UMobaParticlePool>())
+	{
+		return Pool->Spawn(Template, Location, Rotation);
+	}
+	return UGameplayStatics::SpawnEmitterAtLocation(World, Template, Location, Rotation, true);
+}
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaRagdollBudget.h"
+#include "Engine/World.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+
+#include "BattleMoba.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaRagdollBudget, "Ragdoll Budget");
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ragdolls Simulating"), STAT_MobaRagdollsSimulating, STATGROUP_BattleMoba);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ragdolls Refused"), STAT_MobaRagdollsRefused, STATGROUP_BattleMoba);
+
+static TAutoConsoleVariable<int32> CVarMobaRagdollMaxActive(
+	TEXT("Moba.Ragdoll.MaxActive"),
+	4,
+	TEXT("Most knocked-out meshes simulating at once, the oldest is put to sleep past this."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMobaRagdollMaxDistance(
+	TEXT("Moba.Ragdoll.MaxDistance"),
+	3000.0f,
+	TEXT("Knocked-out meshes farther than this from the local camera show a death pose instead of simulating."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMobaRagdollMaxSimTime(
+	TEXT("Moba.Ragdoll.MaxSimTime"),
+	3.0f,
+	TEXT("Seconds a ragdoll simulates at most before its bodies are put to sleep."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMobaRagdollSettleSpeed(
+	TEXT("Moba.Ragdoll.SettleSpeed"),
+	15.0f,
+	TEXT("Root body speed below which a ragdoll counts as settled, once it stays there for half a second."),
+	ECVF_Default);
+
+bool UMobaRagdollBudget::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UMobaRagdollBudget::RequestRagdoll(USkeletalMeshComponent* Mesh)
+{
+	if (Mesh == nullptr)
+	{
+		return false;
+	}
+
+	//		nobody would see the difference between a far ragdoll and a pose
+	APlayerCameraManager* Camera = UGameplayStatics::GetPlayerCameraManager(this, 0);
+	const float MaxDistance = CVarMobaRagdollMaxDistance.GetValueOnGameThread();
+	if (Camera && FVector::DistSquared(Camera->GetCameraLocation(), Mesh->GetComponentLocation()) > FMath::Square(MaxDistance))
+	{
+		INC_DWORD_STAT(STAT_MobaRagdollsRefused);
+		return false;
+	}
+
+	const int32 MaxActive = CVarMobaRagdollMaxActive.GetValueOnGameThread();
+	if (MaxActive <= 0)
+	{
+		INC_DWORD_STAT(STAT_MobaRagdollsRefused);
+		return false;
+	}
+
+	while (Active.Num() >= MaxActive)
+	{
+		Sleep(Active[0].Mesh.Get());
+		Active.RemoveAt(0, 1, false);
+		DEC_DWORD_STAT(STAT_MobaRagdollsSimulating);
+	}
+
+	Mesh->SetCollisionEnabled(ECollisionEnabled::PhysicsOnly);
+	Mesh->SetCollisionObjectType(ECollisionChannel::ECC_PhysicsBody);
+	Mesh->SetSimulatePhysics(true);
+
+	FActiveRagdoll& Ragdoll = Active.AddDefaulted_GetRef();
+	Ragdoll.Mesh = Mesh;
+	Ragdoll.StartTime = GetWorld()->GetTimeSeconds();
+
+	INC_DWORD_STAT(STAT_MobaRagdollsSimulating);
+	return true;
+}
+
+void UMobaRagdollBudget::ReleaseRagdoll(USkeletalMeshComponent* Mesh)
+{
+	const int32 Removed = Active.RemoveAll([Mesh](const FActiveRagdoll& Ragdoll) { return Ragdoll.Mesh.Get() == Mesh; });
+	DEC_DWORD_STAT_BY(STAT_MobaRagdollsSimulating, Removed);
+}
+
+void UMobaRagdollBudget::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_MobaRagdollsSimulating, Active.Num());
+	Active.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMobaRagdollBudget::Sleep(USkeletalMeshComponent* Mesh)
+{
+	if (Mesh != nullptr && Mesh->IsSimulatingPhysics())
+	{
+		//		bodies keep their pose and stop costing a simulation step
+		Mesh->PutAllRigidBodiesToSleep();
+	}
+}
+
+void UMobaRagdollBudget::Tick(float DeltaTime)
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaRagdollBudget);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	const float MaxSimTime = CVarMobaRagdollMaxSimTime.GetValueOnGameThread();
+	const float SettleSpeedSq = FMath::Square(CVarMobaRagdollSettleSpeed.GetValueOnGameThread());
+
+	for (int32 i = Active.Num() - 1; i >= 0; --i)
+	{
+		FActiveRagdoll& Ragdoll = Active[i];
+		USkeletalMeshComponent* Mesh = Ragdoll.Mesh.Get();
+
+		bool bDone = Mesh == nullptr || !Mesh->IsSimulatingPhysics();
+		if (!bDone)
+		{
+			if (Mesh->GetPhysicsLinearVelocity().SizeSquared() < SettleSpeedSq)
+			{
+				if (Ragdoll.SlowSince < 0.0f)
+				{
+					Ragdoll.SlowSince = Now;
+				}
+			}
+			else
+			{
+				Ragdoll.SlowSince = -1.0f;
+			}
+
+			const bool bSettled = Ragdoll.SlowSince >= 0.0f && Now - Ragdoll.SlowSince >= 0.5f;
+			if (bSettled || Now - Ragdoll.StartTime >= MaxSimTime)
+			{
+				Sleep(Mesh);
+				bDone = true;
+			}
+		}
+
+		if (bDone)
+		{
+			Active.RemoveAt(i, 1, false);
+			DEC_DWORD_STAT(STAT_MobaRagdollsSimulating);
+		}
+	}
+}
+
+bool UMobaRagdollBudget::IsTickable() const
+{
+	return !IsTemplate() && Active.Num() > 0;
+}
+
+ETickableTickType UMobaRagdollBudget::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UMobaRagdollBudget::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMobaRagdollBudget, STATGROUP_Tickables);
+}
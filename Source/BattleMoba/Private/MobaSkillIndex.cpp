@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaSkillIndex.h"
+#include "Engine/DataTable.h"
+#include "Animation/AnimMontage.h"
+
+void FMobaSkillIndex::Build(UDataTable* Table)
+{
+	Reset();
+
+	if (Table == nullptr)
+	{
+		return;
+	}
+
+	SourceTable = Table;
+
+	//Used in error reporting
+	FString Context;
+	for (const FName& Name : Table->GetRowNames())
+	{
+		FActionSkill* Row = Table->FindRow<FActionSkill>(Name, Context);
+		if (Row == nullptr)
+		{
+			continue;
+		}
+
+		//		skills travel as a uint8 in RPCs
+		if (Skills.Num() >= MaxSkills)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s has more than %d skills, the rest are ignored"), *Table->GetName(), MaxSkills);
+			break;
+		}
+
+		const int32 SkillIndex = Skills.Add(Row);
+		RowNames.Add(Name);
+		BuildCombo(*Row, Combos.AddDefaulted_GetRef());
+
+		//		earlier rows win, like the row walk this replaces
+		if (!KeyToSkill.Contains(Row->keys))
+		{
+			KeyToSkill.Add(Row->keys, SkillIndex);
+		}
+		if (!ButtonToSkill.Contains(Row->ButtonName))
+		{
+			ButtonToSkill.Add(Row->ButtonName, SkillIndex);
+		}
+	}
+}
+
+void FMobaSkillIndex::Reset()
+{
+	SourceTable.Reset();
+	Skills.Reset();
+	RowNames.Reset();
+	Combos.Reset();
+	KeyToSkill.Reset();
+	ButtonToSkill.Reset();
+}
+
+int32 FMobaSkillIndex::Find(const FKey& Key, const FString& ButtonName) const
+{
+	const int32* ByKey = KeyToSkill.Find(Key);
+	const int32* ByButton = ButtonToSkill.Find(ButtonName);
+
+	if (ByKey && ByButton)
+	{
+		return FMath::Min(*ByKey, *ByButton);
+	}
+	return ByKey ? *ByKey : (ByButton ? *ByButton : INDEX_NONE);
+}
+
+void FMobaSkillIndex::BuildCombo(const FActionSkill& Skill, FMobaComboGraph& OutCombo)
+{
+	if (!Skill.UseSection || Skill.SkillMoveset == nullptr)
+	{
+		return;
+	}
+
+	for (int32 Step = 1; Step <= Skill.Section; ++Step)
+	{
+		//		same naming the montages are authored with
+		const FName Section = FName(*FString::Printf(TEXT("NormalAttack0%d"), Step));
+		const int32 SectionIndex = Skill.SkillMoveset->GetSectionIndex(Section);
+
+		if (SectionIndex == INDEX_NONE || SectionIndex >= MAX_uint8)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s has no section %s, it is left out of the combo"), *Skill.SkillMoveset->GetName(), *Section.ToString());
+			continue;
+		}
+
+		FMobaComboStep& ComboStep = OutCombo.Steps.AddDefaulted_GetRef();
+		ComboStep.Section = Section;
+		ComboStep.SectionId = uint8(SectionIndex);
+		ComboStep.Length = Skill.SkillMoveset->GetSectionLength(SectionIndex);
+	}
+}
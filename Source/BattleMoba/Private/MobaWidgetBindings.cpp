@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaWidgetBindings.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/TextBlock.h"
+#include "Components/ProgressBar.h"
+#include "Components/WidgetComponent.h"
+
+#include "BattleMoba.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Widget Binds"), STAT_MobaWidgetBinds, STATGROUP_BattleMoba);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Widget Slate Writes"), STAT_MobaWidgetWrites, STATGROUP_BattleMoba);
+
+FMobaWidgetBinding::FMobaWidgetBinding(FName InValueTextName, FName InBarName, FName InTeamTextName)
+	: ValueTextName(InValueTextName)
+	, BarName(InBarName)
+	, TeamTextName(InTeamTextName)
+{
+}
+
+bool FMobaWidgetBinding::Bind(UUserWidget* InWidget)
+{
+	if (InWidget == nullptr)
+	{
+		return false;
+	}
+
+	if (Widget.Get() == InWidget)
+	{
+		return true;
+	}
+
+	INC_DWORD_STAT(STAT_MobaWidgetBinds);
+
+	Widget = InWidget;
+	ValueText = nullptr;
+	TeamText = nullptr;
+	Bar = nullptr;
+	ResetCache();
+
+	if (InWidget->WidgetTree)
+	{
+		if (!ValueTextName.IsNone())
+		{
+			ValueText = Cast<UTextBlock>(InWidget->WidgetTree->FindWidget(ValueTextName));
+		}
+
+		if (!TeamTextName.IsNone())
+		{
+			TeamText = Cast<UTextBlock>(InWidget->WidgetTree->FindWidget(TeamTextName));
+		}
+
+		if (!BarName.IsNone())
+		{
+			Bar = Cast<UProgressBar>(InWidget->WidgetTree->FindWidget(BarName));
+		}
+	}
+
+	return true;
+}
+
+bool FMobaWidgetBinding::Bind(UWidgetComponent* Component)
+{
+	return Component != nullptr && Bind(Component->GetUserWidgetObject());
+}
+
+void FMobaWidgetBinding::SetValue(float Value)
+{
+	const int32 NewValue = FMath::FloorToInt(Value);
+	if (NewValue == ShownValue || !ValueText.IsValid())
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MobaWidgetWrites);
+
+	ShownValue = NewValue;
+	ValueText->SetText(FText::AsNumber(NewValue, &FNumberFormattingOptions::DefaultNoGrouping()));
+}
+
+void FMobaWidgetBinding::SetPercent(float Percent)
+{
+	//Quantized to a thousandth, finer steps are not visible on a nameplate sized bar
+	const float NewPercent = FMath::RoundToFloat(FMath::Clamp(Percent, 0.0f, 1.0f) * 1000.0f) / 1000.0f;
+	if (NewPercent == ShownPercent || !Bar.IsValid())
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MobaWidgetWrites);
+
+	ShownPercent = NewPercent;
+	Bar->SetPercent(NewPercent);
+}
+
+void FMobaWidgetBinding::SetColor(const FLinearColor& Color)
+{
+	if (Color == ShownColor)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MobaWidgetWrites);
+
+	ShownColor = Color;
+	if (Bar.IsValid())
+	{
+		Bar->SetFillColorAndOpacity(Color);
+	}
+	if (ValueText.IsValid())
+	{
+		ValueText->SetColorAndOpacity(Color);
+	}
+}
+
+void FMobaWidgetBinding::SetTeam(FName Team)
+{
+	if ((bHasTeam && Team == ShownTeam) || !TeamText.IsValid())
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MobaWidgetWrites);
+
+	ShownTeam = Team;
+	bHasTeam = true;
+	TeamText->SetText(FText::FromName(Team));
+}
+
+float FMobaWidgetBinding::GetPercent() const
+{
+	return Bar.IsValid() ? Bar->Percent : 0.0f;
+}
+
+void FMobaWidgetBinding::ResetCache()
+{
+	ShownValue = MIN_int32;
+	ShownPercent = -1.0f;
+	ShownColor = FLinearColor(0.0f, 0.0f, 0.0f, -1.0f);
+	ShownTeam = NAME_None;
+	bHasTeam = false;
+}
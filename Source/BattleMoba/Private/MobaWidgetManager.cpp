@@ -0,0 +1,381 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaWidgetManager.h"
+#include "Engine/World.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/WidgetComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+
+#include "BattleMoba.h"
+
+MOBA_DECLARE_HOT_PATH(STAT_MobaWidgetManager, "Widget Manager");
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Widgets Active"), STAT_MobaWidgetsActive, STATGROUP_BattleMoba);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Widgets Throttled"), STAT_MobaWidgetsThrottled, STATGROUP_BattleMoba);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Widgets Culled"), STAT_MobaWidgetsCulled, STATGROUP_BattleMoba);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Floating Texts Live"), STAT_MobaFloatingTextsLive, STATGROUP_BattleMoba);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floating Texts Created"), STAT_MobaFloatingTextsCreated, STATGROUP_BattleMoba);
+
+static TAutoConsoleVariable<float> CVarMobaWidgetCullDistance(
+	TEXT("Moba.Widget.CullDistance"),
+	5000.0f,
+	TEXT("World widgets farther than this from the local camera are collapsed and stop ticking."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMobaWidgetThrottleDistance(
+	TEXT("Moba.Widget.ThrottleDistance"),
+	2000.0f,
+	TEXT("World widgets farther than this from the local camera tick every Moba.Widget.ThrottleInterval."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMobaWidgetThrottleInterval(
+	TEXT("Moba.Widget.ThrottleInterval"),
+	0.2f,
+	TEXT("Seconds between ticks of throttled world widgets."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMobaWidgetEvaluateInterval(
+	TEXT("Moba.Widget.EvaluateInterval"),
+	0.1f,
+	TEXT("Seconds between distance and on-screen checks of the world widgets."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMobaFloatingTextMax(
+	TEXT("Moba.FloatingText.Max"),
+	16,
+	TEXT("Most floating damage numbers alive at once, the oldest is reused past this."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMobaFloatingTextLifetime(
+	TEXT("Moba.FloatingText.Lifetime"),
+	1.0f,
+	TEXT("Seconds a floating damage number stays on screen."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMobaFloatingTextRise(
+	TEXT("Moba.FloatingText.Rise"),
+	120.0f,
+	TEXT("World units a floating damage number rises over its lifetime."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld MobaWidgetReportCommand(
+	TEXT("Moba.Widget.Report"),
+	TEXT("Log how many world widgets are active, throttled and culled, and how many floating texts are pooled."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		UMobaWidgetManager* Manager = World ? World->GetSubsystem<UMobaWidgetManager>() : nullptr;
+		if (Manager == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Moba.Widget.Report: no widget manager in this world"));
+			return;
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("Moba.Widget.Report: %d active, %d throttled, %d culled, %d floating texts pooled"),
+			Manager->GetActiveCount(), Manager->GetThrottledCount(), Manager->GetCulledCount(), Manager->GetFloatingTextCount());
+	}));
+
+bool UMobaWidgetManager::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UMobaWidgetManager::Deinitialize()
+{
+	for (UUserWidget* Text : FloatingWidgets)
+	{
+		if (Text != nullptr)
+		{
+			Text->RemoveFromParent();
+		}
+	}
+	FloatingWidgets.Reset();
+	FloatingTexts.Reset();
+
+	DEC_DWORD_STAT_BY(STAT_MobaWidgetsActive, NumActive);
+	DEC_DWORD_STAT_BY(STAT_MobaWidgetsThrottled, NumThrottled);
+	DEC_DWORD_STAT_BY(STAT_MobaWidgetsCulled, NumCulled);
+	DEC_DWORD_STAT_BY(STAT_MobaFloatingTextsLive, NumLiveTexts);
+	NumActive = NumThrottled = NumCulled = NumLiveTexts = 0;
+	Widgets.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMobaWidgetManager::RegisterWidget(UWidgetComponent* Widget)
+{
+	if (Widget == nullptr || Widgets.ContainsByPredicate([Widget](const FManagedWidget& Managed) { return Managed.Widget.Get() == Widget; }))
+	{
+		return;
+	}
+
+	FManagedWidget& Managed = Widgets.AddDefaulted_GetRef();
+	Managed.Widget = Widget;
+
+	//		counted as active until the next evaluation says otherwise
+	++NumActive;
+	INC_DWORD_STAT(STAT_MobaWidgetsActive);
+	NextEvaluateTime = 0.0f;
+}
+
+void UMobaWidgetManager::UnregisterWidget(UWidgetComponent* Widget)
+{
+	const int32 Index = Widgets.IndexOfByPredicate([Widget](const FManagedWidget& Managed) { return Managed.Widget.Get() == Widget; });
+	if (Index != INDEX_NONE)
+	{
+		SetState(Widgets[Index], EWidgetState::Active);
+		--NumActive;
+		DEC_DWORD_STAT(STAT_MobaWidgetsActive);
+		Widgets.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+void UMobaWidgetManager::SetState(FManagedWidget& Managed, EWidgetState State)
+{
+	if (Managed.State == State)
+	{
+		return;
+	}
+
+	switch (Managed.State)
+	{
+	case EWidgetState::Active:		--NumActive;	DEC_DWORD_STAT(STAT_MobaWidgetsActive);		break;
+	case EWidgetState::Throttled:	--NumThrottled;	DEC_DWORD_STAT(STAT_MobaWidgetsThrottled);	break;
+	case EWidgetState::Culled:		--NumCulled;	DEC_DWORD_STAT(STAT_MobaWidgetsCulled);		break;
+	}
+
+	switch (State)
+	{
+	case EWidgetState::Active:		++NumActive;	INC_DWORD_STAT(STAT_MobaWidgetsActive);		break;
+	case EWidgetState::Throttled:	++NumThrottled;	INC_DWORD_STAT(STAT_MobaWidgetsThrottled);	break;
+	case EWidgetState::Culled:		++NumCulled;	INC_DWORD_STAT(STAT_MobaWidgetsCulled);		break;
+	}
+
+	const EWidgetState OldState = Managed.State;
+	Managed.State = State;
+
+	UWidgetComponent* Widget = Managed.Widget.Get();
+	if (Widget == nullptr)
+	{
+		return;
+	}
+
+	//		collapsing the user widget leaves the component visibility to the occlusion sweeps
+	UUserWidget* UserWidget = Widget->GetUserWidgetObject();
+	if (State == EWidgetState::Culled)
+	{
+		if (UserWidget)
+		{
+			Managed.VisibleAs = UserWidget->GetVisibility();
+			UserWidget->SetVisibility(ESlateVisibility::Collapsed);
+		}
+		Widget->SetComponentTickEnabled(false);
+		return;
+	}
+
+	if (OldState == EWidgetState::Culled)
+	{
+		if (UserWidget)
+		{
+			UserWidget->SetVisibility(Managed.VisibleAs);
+		}
+		Widget->SetComponentTickEnabled(true);
+	}
+
+	Widget->SetComponentTickInterval(State == EWidgetState::Throttled ? CVarMobaWidgetThrottleInterval.GetValueOnGameThread() : 0.0f);
+}
+
+void UMobaWidgetManager::Evaluate()
+{
+	APlayerController* PC = UGameplayStatics::GetPlayerController(this, 0);
+	if (PC == nullptr || PC->PlayerCameraManager == nullptr)
+	{
+		return;
+	}
+
+	const FVector CameraLocation = PC->PlayerCameraManager->GetCameraLocation();
+	const float CullDistanceSq = FMath::Square(CVarMobaWidgetCullDistance.GetValueOnGameThread());
+	const float ThrottleDistanceSq = FMath::Square(CVarMobaWidgetThrottleDistance.GetValueOnGameThread());
+
+	//		a headless client has no viewport, everything counts as off-screen there
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	PC->GetViewportSize(SizeX, SizeY);
+	const FVector2D Margin(SizeX * 0.1f, SizeY * 0.1f);
+
+	for (int32 i = Widgets.Num() - 1; i >= 0; --i)
+	{
+		FManagedWidget& Managed = Widgets[i];
+		UWidgetComponent* Widget = Managed.Widget.Get();
+		if (Widget == nullptr)
+		{
+			SetState(Managed, EWidgetState::Active);
+			--NumActive;
+			DEC_DWORD_STAT(STAT_MobaWidgetsActive);
+			Widgets.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		const FVector Location = Widget->GetComponentLocation();
+		const float DistanceSq = FVector::DistSquared(Location, CameraLocation);
+
+		FVector2D Screen;
+		const bool bOnScreen = PC->ProjectWorldLocationToScreen(Location, Screen, true)
+			&& Screen.X >= -Margin.X && Screen.X <= SizeX + Margin.X
+			&& Screen.Y >= -Margin.Y && Screen.Y <= SizeY + Margin.Y;
+
+		if (!bOnScreen || DistanceSq > CullDistanceSq)
+		{
+			SetState(Managed, EWidgetState::Culled);
+		}
+		else
+		{
+			SetState(Managed, DistanceSq > ThrottleDistanceSq ? EWidgetState::Throttled : EWidgetState::Active);
+		}
+	}
+}
+
+void UMobaWidgetManager::ShowFloatingText(TSubclassOf<UUserWidget> Class, const FVector& WorldLocation, float Value)
+{
+	APlayerController* PC = UGameplayStatics::GetPlayerController(this, 0);
+	const int32 MaxTexts = CVarMobaFloatingTextMax.GetValueOnGameThread();
+	if (Class == nullptr || PC == nullptr || MaxTexts <= 0)
+	{
+		return;
+	}
+
+	//		nobody reads a damage number past the distance the nameplates are culled at
+	if (PC->PlayerCameraManager && FVector::DistSquared(PC->PlayerCameraManager->GetCameraLocation(), WorldLocation) > FMath::Square(CVarMobaWidgetCullDistance.GetValueOnGameThread()))
+	{
+		return;
+	}
+
+	int32 Index = INDEX_NONE;
+	int32 Oldest = INDEX_NONE;
+	for (int32 i = 0; i < FloatingTexts.Num(); ++i)
+	{
+		const FFloatingText& Text = FloatingTexts[i];
+		if (Text.Class != Class)
+		{
+			continue;
+		}
+		if (!Text.bLive)
+		{
+			Index = i;
+			break;
+		}
+		if (Oldest == INDEX_NONE || Text.StartTime < FloatingTexts[Oldest].StartTime)
+		{
+			Oldest = i;
+		}
+	}
+
+	if (Index == INDEX_NONE && FloatingTexts.Num() < MaxTexts)
+	{
+		UUserWidget* Widget = CreateWidget<UUserWidget>(PC, Class);
+		if (Widget == nullptr)
+		{
+			return;
+		}
+		Widget->AddToViewport();
+		Widget->SetAlignmentInViewport(FVector2D(0.5f, 1.0f));
+		Widget->SetVisibility(ESlateVisibility::Collapsed);
+
+		INC_DWORD_STAT(STAT_MobaFloatingTextsCreated);
+
+		Index = FloatingWidgets.Add(Widget);
+		FFloatingText& Text = FloatingTexts.AddDefaulted_GetRef();
+		Text.Class = Class;
+		Text.Binding = FMobaWidgetBinding(TEXT("ValueText"), NAME_None);
+		Text.Binding.Bind(Widget);
+	}
+
+	if (Index == INDEX_NONE)
+	{
+		Index = Oldest;
+	}
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	FFloatingText& Text = FloatingTexts[Index];
+	if (!Text.bLive)
+	{
+		++NumLiveTexts;
+		INC_DWORD_STAT(STAT_MobaFloatingTextsLive);
+	}
+
+	Text.bLive = true;
+	Text.Location = WorldLocation;
+	Text.StartTime = GetWorld()->GetTimeSeconds();
+	Text.Binding.SetValue(Value);
+
+	FloatingWidgets[Index]->SetVisibility(ESlateVisibility::HitTestInvisible);
+}
+
+void UMobaWidgetManager::TickFloatingTexts()
+{
+	APlayerController* PC = UGameplayStatics::GetPlayerController(this, 0);
+	const float Now = GetWorld()->GetTimeSeconds();
+	const float Lifetime = FMath::Max(CVarMobaFloatingTextLifetime.GetValueOnGameThread(), KINDA_SMALL_NUMBER);
+	const float Rise = CVarMobaFloatingTextRise.GetValueOnGameThread();
+
+	for (int32 i = 0; i < FloatingTexts.Num(); ++i)
+	{
+		FFloatingText& Text = FloatingTexts[i];
+		UUserWidget* Widget = FloatingWidgets[i];
+		if (!Text.bLive || Widget == nullptr)
+		{
+			continue;
+		}
+
+		const float Alpha = (Now - Text.StartTime) / Lifetime;
+		FVector2D Screen;
+		if (Alpha >= 1.0f || PC == nullptr || !PC->ProjectWorldLocationToScreen(Text.Location + FVector(0.0f, 0.0f, Rise * Alpha), Screen, true))
+		{
+			Text.bLive = false;
+			--NumLiveTexts;
+			DEC_DWORD_STAT(STAT_MobaFloatingTextsLive);
+			Widget->SetVisibility(ESlateVisibility::Collapsed);
+			continue;
+		}
+
+		Widget->SetPositionInViewport(Screen, true);
+		Widget->SetRenderOpacity(1.0f - Alpha);
+	}
+}
+
+void UMobaWidgetManager::Tick(float DeltaTime)
+{
+	MOBA_SCOPE_CYCLE(STAT_MobaWidgetManager);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now >= NextEvaluateTime)
+	{
+		NextEvaluateTime = Now + CVarMobaWidgetEvaluateInterval.GetValueOnGameThread();
+		Evaluate();
+	}
+
+	if (NumLiveTexts > 0)
+	{
+		TickFloatingTexts();
+	}
+}
+
+bool UMobaWidgetManager::IsTickable() const
+{
+	return !IsTemplate() && (Widgets.Num() > 0 || NumLiveTexts > 0);
+}
+
+ETickableTickType UMobaWidgetManager::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UMobaWidgetManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMobaWidgetManager, STATGROUP_Tickables);
+}
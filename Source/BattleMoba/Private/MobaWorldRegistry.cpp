@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MobaWorldRegistry.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+
+#include "BattleMobaGameMode.h"
+#include "BattleMobaGameState.h"
+
+UMobaWorldRegistry* UMobaWorldRegistry::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UMobaWorldRegistry>() : nullptr;
+}
+
+ABattleMobaGameMode* UMobaWorldRegistry::GetGameMode() const
+{
+	return GetWorld() ? GetWorld()->GetAuthGameMode<ABattleMobaGameMode>() : nullptr;
+}
+
+ABattleMobaGameState* UMobaWorldRegistry::GetGameState() const
+{
+	return GetWorld() ? GetWorld()->GetGameState<ABattleMobaGameState>() : nullptr;
+}
+
+void UMobaWorldRegistry::Deinitialize()
+{
+	Characters.Reset();
+	PlayerStates.Reset();
+	Flags.Reset();
+	Towers.Reset();
+	SafeZones.Reset();
+
+	Super::Deinitialize();
+}
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/TriggerCapsule.h"
+#include "MobaWidgetBindings.h"
 #include "BMobaTriggerCapsule.generated.h"
 
 /**
@@ -34,6 +35,9 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
 		class UWidgetComponent* W_Val;
 
+	//		Cached ValText and PBar of W_Val
+	FMobaWidgetBinding ValueWidget;
+
 	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_Val, BlueprintReadWrite, Category = "Status")
 		float val = 0.0f;
 	UFUNCTION()
@@ -42,14 +46,19 @@ public:
 	UPROPERTY(Replicated)
 		FTimerHandle FlagTimer;
 
-	UPROPERTY(Replicated)
+	UPROPERTY(ReplicatedUsing = OnRep_Team)
 		FName TeamName;
 
+	UFUNCTION()
+		void OnRep_Team();
+
 protected:
 
 		//Called when the game starts or when spawned
 		virtual void BeginPlay() override;
 
+		virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 private:
 
 	//overlap begin function
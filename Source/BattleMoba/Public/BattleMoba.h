@@ -3,3 +3,28 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_STATS_GROUP(TEXT("BattleMoba"), STATGROUP_BattleMoba, STATCAT_Advanced);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(BATTLEMOBA_API, BattleMoba);
+
+/**
+ * Gameplay hot paths are measured by both the stat system (stat BattleMoba) and the CSV profiler
+ * (BattleMoba category, e.g. CsvProfile Start on a dedicated server). MOBA_DECLARE_HOT_PATH declares
+ * the cycle stat and its per-frame call count, MOBA_SCOPE_CYCLE times the enclosing scope under both.
+ */
+#define MOBA_DECLARE_HOT_PATH(Stat, Name) \
+	DECLARE_CYCLE_STAT(TEXT(Name), Stat, STATGROUP_BattleMoba); \
+	DECLARE_DWORD_COUNTER_STAT(TEXT(Name " Calls"), Stat##Calls, STATGROUP_BattleMoba)
+
+#define MOBA_SCOPE_CYCLE(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	INC_DWORD_STAT(Stat##Calls); \
+	CSV_SCOPED_TIMING_STAT(BattleMoba, Stat); \
+	CSV_CUSTOM_STAT(BattleMoba, Stat##Calls, 1, ECsvCustomStatOp::Accumulate)
+
+//Shared by every world-space widget refresh
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Widget Update"), STAT_MobaWidgetUpdate, STATGROUP_BattleMoba, BATTLEMOBA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Widget Update Calls"), STAT_MobaWidgetUpdateCalls, STATGROUP_BattleMoba, BATTLEMOBA_API);
@@ -4,9 +4,49 @@
 
 #include "CoreMinimal.h"
 #include "Engine/TriggerSphere.h"
+#include "MobaWidgetBindings.h"
 #include "BattleMobaCTF.generated.h"
 
 class ABattleMobaCharacter;
+
+/**		Server owned capture state, one property per flag regardless of how many players stand on it*/
+USTRUCT()
+struct FMobaCaptureProgress
+{
+	GENERATED_BODY()
+
+	static constexpr int32 MaxProgress = 100;
+
+	//		signed progress, positive towards Radiant and negative towards Dire
+	UPROPERTY()
+		int8 Progress = 0;
+
+	//		+1 while Radiant captures, -1 while Dire captures, 0 while the flag is empty or contested
+	UPROPERTY()
+		int8 Direction = 0;
+
+	//		milliseconds the server takes per progress point
+	UPROPERTY()
+		uint16 StepMs = 0;
+
+	bool IsMoving() const
+	{
+		return Direction != 0 && StepMs > 0 && FMath::Abs(Progress + Direction) <= MaxProgress;
+	}
+
+	//		progress expected Elapsed seconds after this state was received, at most two steps ahead so dropped updates cannot run away
+	float Extrapolate(float Elapsed) const
+	{
+		if (!IsMoving())
+		{
+			return float(Progress);
+		}
+
+		const float Steps = FMath::Min(Elapsed * 1000.0f / float(StepMs), 2.0f);
+		return FMath::Clamp(float(Progress) + float(Direction) * Steps, -float(MaxProgress), float(MaxProgress));
+	}
+};
+
 /**
  * 
  */
@@ -17,6 +57,10 @@ class BATTLEMOBA_API ABattleMobaCTF : public ATriggerSphere
 		//Replicated Network setup
 		void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+		virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack) override;
+
+		virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
 public:
 	// Sets default values for this actor's properties
 	ABattleMobaCTF();
@@ -25,6 +69,11 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Extrapolates the capture widget between server updates
+	virtual void Tick(float DeltaSeconds) override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	//overlap begin function
 	UFUNCTION()
 		void OnOverlapBegin(class AActor* OverlappedActor, class AActor* OtherActor);
@@ -49,12 +98,29 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
 		class UWidgetComponent* W_ValControl;
 
-	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_Val, BlueprintReadWrite, Category = "Status")
+	//		Cached ValText and PBar of W_ValControl
+	FMobaWidgetBinding ValueWidget;
+
+	//		displayed progress, derived locally from Capture
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Status")
 		float valRadiant = 0.0f;
 
-	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_Val, BlueprintReadWrite, Category = "Status")
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Status")
 		float valDire = 0.0f;
 
+	UPROPERTY(ReplicatedUsing = OnRep_Capture)
+		FMobaCaptureProgress Capture;
+
+	//		world time the current Capture was received at
+	float CaptureReceivedAt = 0.0f;
+
+	UFUNCTION()
+		void OnRep_Capture();
+
+	//		Sets valRadiant and valDire from the extrapolated Capture and updates the widget
+	void RefreshCaptureWidget();
+
+	//		Updates the widget from valRadiant and valDire
 	UFUNCTION()
 		void OnRep_Val();
 
@@ -68,16 +134,19 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Status")
 		float SpeedMultiplier = 0.05f;
 
-	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "Status")
+	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_ControllerTeam, BlueprintReadWrite, Category = "Status")
 		FName ControllerTeam = "";
 
+	UFUNCTION()
+		void OnRep_ControllerTeam();
+
 	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "Status")
 		TArray<AActor*> OverlappedPlayer;
 
 	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "Status")
 		ABattleMobaCharacter* ActivePlayer;
 
-	//	how many of Radiant Players inside of Control Flag radius
+	//	how many of Radiant Players inside of Control Flag radius, maintained by the overlap events on the server
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Replicated, Category = "Status")
 		int RadiantControl = 0;
 
@@ -87,9 +156,6 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Replicated, Category = "Status")
 		bool isCompleted = false;
 
-	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "Status")
-		TArray<AActor*> GiveGoldActors;
-
 	UPROPERTY(Replicated)
 		FTimerHandle FlagTimer;
 
@@ -97,8 +163,13 @@ public:
 		FTimerHandle GoldTimer;
 
 
+	//		team currently advancing the capture, None while the flag is empty or contested
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Status")
+		FName CaptureTeam = "";
+
 public:
 
+	//		advances the capture by one step for CaptureTeam, runs every ControllingSpeed on the server
 	void TimerFunction();
 
 	void GoldTimerFunction();
@@ -116,5 +187,11 @@ protected:
 	//		Flag Name
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Status")
 		FName PointName = "BaseFlag";
+
+	//		adds Delta to the occupancy counter of the player's team
+	void UpdateOccupancy(ABattleMobaCharacter* Player, int32 Delta);
+
+	//		picks the capturing team and capture speed from the counters, re-arms FlagTimer only when they changed
+	void RecomputeCaptureRate();
 	
 };
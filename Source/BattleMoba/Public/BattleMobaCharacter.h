@@ -7,12 +7,20 @@
 #include "InputLibrary.h"
 #include "GameFramework/Character.h"
 #include "BattleMobaAnimInstance.h"
+#include "MobaLagCompensation.h"
+#include "MobaSkillIndex.h"
+#include "MobaCombatTraceBatcher.h"
+#include "CombatSubsystem.h"
+#include "MobaWidgetBindings.h"
 #include "BattleMobaCharacter.generated.h"
 
 class ABMobaTriggerCapsule;
 struct FTimerHandle;
 class ABattleMobaCTF;
 
+//Character, key and button of a skill press, before cooldowns are checked
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FMobaSkillButtonDelegate, ABattleMobaCharacter*, const FKey&, const FString&);
+
 UCLASS(config = Game)
 class ABattleMobaCharacter : public ACharacter
 {
@@ -21,6 +29,10 @@ class ABattleMobaCharacter : public ACharacter
 	//Replicated Network setup
 		void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+		virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack) override;
+
+		virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
 	/** Camera boom positioning the camera behind the character */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 		class USpringArmComponent* CameraBoom;
@@ -37,105 +49,19 @@ class ABattleMobaCharacter : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, Meta = (AllowPrivateAccess = "true"))
 		class UStaticMeshComponent* Outline;
 
+	////3D UI On Player's head
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LeftKickCol;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LKC1;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LKC2;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LKC3;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LKC4;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LKC5;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LKC6;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RightKickCol;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RKC1;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RKC2;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RKC3;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RKC4;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RKC5;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RKC6;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UArrowComponent* LKickArrow;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UArrowComponent* RKickArrow;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LeftPunchCol;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LPC1;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LPC2;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LPC3;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LPC4;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LPC5;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* LPC6;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RightPunchCol;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RPC1;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RPC2;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RPC3;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RPC4;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RPC5;
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UBoxComponent* RPC6;
+		class UWidgetComponent* W_DamageOutput;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UArrowComponent* LPunchArrow;
+	//		Cached HealthText, HPBar and TeamName of W_DamageOutput
+	FMobaWidgetBinding HealthWidget;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UArrowComponent* RPunchArrow;
+	//		Floating damage number shown above this character when its health drops, needs a ValueText block
+	UPROPERTY(EditDefaultsOnly, Category = "HUD")
+		TSubclassOf<class UUserWidget> FloatingDamageClass;
 
-	////3D UI On Player's head
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Components, meta = (AllowPrivateAccess = "true"))
-		class UWidgetComponent* W_DamageOutput;
+	//		Health as last shown on this machine, negative until the first update
+	float ShownHealth = -1.0f;
 
 public:
 	ABattleMobaCharacter();
@@ -170,9 +96,6 @@ public:
 	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "Status")
 		TArray<class ABattleMobaPlayerState*> DamageDealers;
 
-	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "ControlFlag")
-		bool CTFentering;
-
 	UPROPERTY(VisibleAnywhere, Replicated, Category = "ControlFlag")
 		TArray<AActor*> ActorsToGetGold;
 
@@ -263,10 +186,13 @@ protected:
 	UPROPERTY(VisibleAnywhere, Replicated, Category = "ActionSkill")
 		UAnimMontage* CounterMoveset;
 
-	//Assign data table from bp 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	//Assign data table from bp, replicated so skill RPCs can send row indices
+	UPROPERTY(EditAnywhere, ReplicatedUsing = OnRep_ActionTable, BlueprintReadWrite)
 		class UDataTable* ActionTable;
 
+	UFUNCTION()
+		void OnRep_ActionTable();
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Battle Style")
 		class UDataTable* SltActionTable;
 
@@ -276,6 +202,16 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Battle Style")
 		class UDataTable* ShaActionTable;
 
+	//Rows of ActionTable indexed by key and button, rebuilt whenever the table changes
+	FMobaSkillIndex SkillIndex;
+
+	//Server time at which each skill of SkillIndex can be used again, only the owner receives it
+	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadOnly, Category = "Cooldown")
+		TArray<float> SkillReadyTimes;
+
+	//How early, in seconds, the server accepts a skill the owner believes is off cooldown
+	static constexpr float SkillCooldownTolerance = 0.1f;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "HitReaction")
 		UAnimMontage* HitReactionMoveset;
 
@@ -324,6 +260,9 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "UI")
 		bool WithinVicinity = false;
 
+	//		WithinVicinity as last passed to UMobaNameplateOcclusion
+	bool bNameplateTracked = false;
+
 	UPROPERTY(BlueprintReadOnly, Category = "Rotate")
 		TArray<AActor*> FoundActors;
 
@@ -342,6 +281,21 @@ protected:
 	UFUNCTION()
 		void OnRep_Health();
 
+	//Recent hits taken, replaces the per-hit reaction multicast
+	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_HitReactions, Category = "HitReaction")
+		FMobaHitReactionArray HitReactions;
+
+	UFUNCTION()
+		void OnRep_HitReactions();
+
+	uint64 LastHitReactionFrame = 0;
+
+	//Sequence of the reaction this machine played last
+	uint8 LastPlayedHitSequence = 0;
+
+	//False until this client has received HitReactions once, reactions from before that are history
+	bool bHitReactionsSynced = false;
+
 	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "Status")
 		float Stamina;
 
@@ -358,13 +312,30 @@ protected:
 	UPROPERTY(VisibleAnywhere, Replicated, Category = "ActionSkill")
 		int comboCount = 0;
 
-	UPROPERTY(VisibleAnywhere, Replicated, Category = "ActionSkill")
-		bool OnComboDelay = false;
+	//Seconds before the next combo section is ready in which a press is kept and played once it is
+	UPROPERTY(EditAnywhere, Category = "ActionSkill")
+		float ComboInputBuffer = 0.3f;
 
 	//*********************Knockout and Respawn***********************************//
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Respawn")
 		FTimerHandle RespawnTimer;
 
+	//Held on knocked-out characters that do not get a ragdoll, see UMobaRagdollBudget
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Knockout")
+		UAnimSequenceBase* DeathPose;
+
+	//Bumped by every in-place respawn so clients undo the knockout on this pawn too
+	UPROPERTY(ReplicatedUsing = OnRep_RespawnCount)
+		uint8 RespawnCount = 0;
+
+	UFUNCTION()
+		void OnRep_RespawnCount();
+
+	//Mesh setup captured at BeginPlay, restored when a pooled pawn comes back
+	FTransform MeshRelativeTransform;
+
+	FName MeshCollisionProfile;
+
 	UPROPERTY(VisibleAnywhere, Category = "Anim")
 		class UBattleMobaAnimInstance* AnimInsta;
 
@@ -375,9 +346,6 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "HitReaction")
 		FName ActiveSocket;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Replicated, Category = "ControlFlag")
-		FName CTFteam = "";
-
 	UPROPERTY(VisibleAnywhere, Category = "Rotate")
 		float RotateRadius = 100.0f;
 
@@ -390,8 +358,9 @@ protected:
 	UPROPERTY()
 		TArray<class ABattleMobaCTF*> Towers;
 
-	UPROPERTY(VisibleAnywhere, Replicated, Category = "HitReaction")
-		TArray<class UBoxComponent*> ActiveColliders;
+	//Limb hitboxes used by AttackTrace and FireTrace, falls back to the built-in layout when unset
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "HitReaction")
+		class UMobaHitboxSet* HitboxSet;
 
 	UPROPERTY(VisibleAnywhere, Replicated, Category = "HitReaction")
 		TArray<class AActor*> ArrDamagedEnemy;
@@ -400,6 +369,9 @@ protected:
 		bool bApplyHitTrace = true;
 
 	FCollisionQueryParams AttackTraceParams;
+
+	//Recent hurtbox transforms, recorded on the server for lag compensated attack traces
+	FMobaPoseHistory PoseHistory;
 		TEnumAsByte<ETouchIndex::Type> MoveTouchIndex;
 	
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
@@ -414,6 +386,10 @@ protected:
 	virtual void PossessedBy(class AController* NewController) override;
 
 	virtual void BeginPlay() override;
+
+	virtual void PostNetInit() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	// End of APawn interface
 
 	virtual void OnConstruction(const FTransform& Transform) override;
@@ -441,9 +417,6 @@ protected:
 	UFUNCTION(Reliable, Server, WithValidation, Category = "Movement")
 	void ServerSetMaxWalkSpeed(float Val);
 
-	UFUNCTION(Reliable, NetMulticast, WithValidation, Category = "Transformation")
-	void RotateToCameraView(FRotator InRot);
-
 	UFUNCTION(BlueprintImplementableEvent, Category = "Damage")
 	void Setup3DWidgetVisibility();
 
@@ -453,24 +426,16 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "HUDSetup")
 	void HideHPBar();
 
-	UFUNCTION(Reliable, Server, WithValidation, BlueprintCallable, Category = "HitReaction")
-		void AttackTrace(bool traceStart, int activeAttack);
-
-	UFUNCTION(Reliable, Server, WithValidation, Category = "HitReaction")
-		void HitResult(FHitResult hit);
+	/**		Server only, applies damage, knockout and kill credit and records the reaction for replication*/
+	void ReceiveHit(ABattleMobaCharacter* Attacker, float DamageReceived, EMobaHitDirection Direction, FName MontageSection);
 
-	//Skill sent to server
-	UFUNCTION(Reliable, Server, WithValidation, BlueprintCallable, Category = "HitReaction")
-		void FireTrace(UBoxComponent* Col1, UBoxComponent* Col2, UBoxComponent* Col3, UBoxComponent* Col4, UBoxComponent* Col5, UBoxComponent* Col6);
-
-	UFUNCTION(Reliable, Server, WithValidation, Category = "HitReaction")
-		void DoDamage(AActor* HitActor);
+	void PlayHitReaction(const FMobaHitReaction& Reaction);
 
-	UFUNCTION(Reliable, Server, WithValidation, Category = "ReceiveDamage")
-		void HitReactionServer(AActor* HitActor, float DamageReceived, UAnimMontage* HitMoveset, FName MontageSection);
+	//Stops the character and ragdolls it within the ragdoll budget, or holds the death pose
+	void EnterKnockout();
 
-	UFUNCTION(Reliable, NetMulticast, WithValidation, Category = "ReceiveDamage")
-		void HitReactionClient(AActor* HitActor, float DamageReceived, UAnimMontage* HitMoveset, FName MontageSection);
+	//Hit moveset of the skill this character is using, as seen from the victim's side
+	UAnimMontage* GetHitMoveset(EMobaHitDirection Direction) const;
 
 	UFUNCTION(Reliable, Server, WithValidation, BlueprintCallable, Category = "HitReaction")
 		void StunPlayerServer(bool checkStun);
@@ -481,20 +446,12 @@ protected:
 	UFUNCTION(Reliable, Server, WithValidation, BlueprintCallable, Category = "HitReaction")
 		void ServerRotateHitActor(AActor* HitActor, AActor* Attacker);
 
-	UFUNCTION(Reliable, NetMulticast, WithValidation, BlueprintCallable, Category = "HitReaction")
-		void MulticastRotateHitActor(AActor* HitActor, AActor* Attacker);
-
 	UFUNCTION(Reliable, Server, WithValidation, BlueprintCallable, Category = "HitReaction")
 		void ServerSpawnEffect(ABattleMobaCharacter* EmitActor, ABattleMobaCharacter* HitActor);
 
-	UFUNCTION(Reliable, NetMulticast, WithValidation, BlueprintCallable, Category = "HitReaction")
-		void MulticastSpawnEffect(ABattleMobaCharacter* EmitActor, ABattleMobaCharacter* HitActor);
-
 	UFUNCTION(Reliable, Server, WithValidation, BlueprintCallable, Category = "HitReaction")
 		void SetActiveSocket(FName SocketName);
 
-	UFUNCTION(Reliable, NetMulticast, WithValidation, Category = "HitReaction")
-		void MulticastSetActiveSocket(FName SocketName);
 
 
 	UFUNCTION()
@@ -502,15 +459,52 @@ protected:
 
 	//Skill sent to server
 	UFUNCTION(Reliable, Server, WithValidation, Category = "ActionSkill")
-		void ServerExecuteAction(FActionSkill SelectedRow, FName MontageSection, bool bSpecialAttack);
+		void ServerExecuteAction(uint8 SkillId, uint8 SectionId, bool bSpecialAttack);
 
 	//Skill replicate on all client
 	UFUNCTION(Reliable, NetMulticast, WithValidation, Category = "ActionSkill")
-		void MulticastExecuteAction(FActionSkill SelectedRow, FName MontageSection, bool bSpecialAttack);
+		void MulticastExecuteAction(uint8 SkillId, uint8 SectionId, bool bSpecialAttack);
 
 	//Get skills from input touch combo
 	UFUNCTION(BlueprintCallable, Category = "ActionSkill")
-		void AttackCombo(FActionSkill SelectedRow);
+		void AttackCombo(uint8 SkillId);
+
+	//Play the next section of the combo skill and note when the one after it may start
+	void AdvanceCombo(uint8 SkillId, float Now);
+
+	//World time the next combo section may start, the current section length plus comboInterval
+	float ComboReadyTime = 0.0f;
+
+	//Combo skill pressed inside the input buffer, INDEX_NONE if none
+	int32 BufferedComboSkill = INDEX_NONE;
+
+	float GetServerTime() const;
+
+	bool IsSkillReady(int32 Index) const;
+
+	void StartSkillCooldown(int32 Index);
+
+	//Server side check and start of a skill cooldown, false if the skill is still cooling down
+	bool TryStartSkillCooldown(int32 Index);
+
+	//Montage section of a skill as sent over the network, NoSkillSection when the montage has no such section
+	uint8 GetSkillSectionId(int32 SkillId, FName Section);
+
+	FName GetSkillSectionName(int32 SkillId, uint8 SectionId);
+
+	//Row of ActionTable by skill index, building the index first if the table changed
+	const FActionSkill* FindSkill(int32 SkillId);
+
+	//Rebuild SkillIndex from ActionTable and prewarm the skills' hit impacts
+	void BuildSkillIndex();
+
+	static constexpr uint8 NoSkillSection = MAX_uint8;
+
+	void ResetSkillCooldowns();
+
+	//Seconds left on the cooldown of the skill bound to Key or ButtonName, for the cooldown UI
+	UFUNCTION(BlueprintPure, Category = "Cooldown")
+		float GetSkillCooldownRemaining(FKey Key, FString ButtonName) const;
 
 	UFUNCTION(Reliable, Server, WithValidation, Category = "ActionSkill")
 		void ServerCounterAttack(ABattleMobaCharacter* hitActor);
@@ -521,6 +515,9 @@ protected:
 	//*********************Knockout and Respawn***********************************//
 	UFUNCTION(Reliable, Client, WithValidation, Category = "Knockout")
 		void RespawnCharacter();
+
+	//Undoes EnterKnockout on this machine
+	void RestoreFromKnockout();
 	
 	//Resets Movement Mode
 	UFUNCTION(BlueprintCallable, Category = "Movement")
@@ -529,17 +526,11 @@ protected:
 	UFUNCTION(BlueprintCallable, NetMulticast, Reliable, WithValidation)
 		void SetupStats();
 
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ControlFlagServer(ABattleMobaCTF* cf);
-
-	UFUNCTION(NetMulticast, Unreliable, WithValidation)
-		void ControlFlagMulticast(ABattleMobaCTF* cf, FName Team);
-
 	UFUNCTION(Reliable, Server, WithValidation, BlueprintCallable, meta = (ExpandEnumAsExecs = Type), Category = "ActionSkill")
-		void DetectNearestTarget(EResult Type, FActionSkill SelectedRow);
+		void DetectNearestTarget(EResult Type, uint8 SkillId);
 
 	UFUNCTION(Reliable, NetMulticast, WithValidation, BlueprintCallable, Category = "ActionSkill")
-		void RotateNearestTarget(AActor* Target, EResult Type, FActionSkill SelectedRow);
+		void RotateNearestTarget(AActor* Target, EResult Type, uint8 SkillId);
 
 	UFUNCTION(BlueprintImplementableEvent, Category = "Effects")
 		void CombatCamShake();
@@ -547,10 +538,72 @@ protected:
 	
 
 public:
+
+	//Server only, hides the knocked-out pawn so the game mode can respawn it in place later
+	void ParkForPool();
+
+	//Server only, brings a parked pawn back at SpawnTransform with full health and no cooldowns
+	void ResetForRespawn(const FTransform& SpawnTransform);
+
 	/** Returns CameraBoom subobject **/
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** Returns the server-side hurtbox history used for rewinding **/
+	FORCEINLINE const FMobaPoseHistory& GetPoseHistory() const { return PoseHistory; }
+	/** Returns the index of the current ActionTable **/
+	FORCEINLINE const FMobaSkillIndex& GetSkillIndex() const { return SkillIndex; }
+	/** Returns how far an attack trace reaches past its hitbox **/
+	FORCEINLINE float GetTraceDistance() const { return TraceDistance; }
+	/** Returns the query params every attack trace of this character uses **/
+	FORCEINLINE const FCollisionQueryParams& GetAttackTraceParams() const { return AttackTraceParams; }
+
+	//Hitbox volumes of an attack slot, from HitboxSet or the built-in layout
+	const TArray<struct FMobaHitboxVolume>* GetAttackSlotVolumes(int activeAttack) const;
+
+	//Called by the combat trace batcher with the hits of a queued attack
+	void ResolveAttackTrace(EMobaCombatTraceKind Kind, int activeAttack, const TArray<FHitResult>& Hits);
+
+	//Stamps the attack with the server time the client currently sees and sends it to the server
+	UFUNCTION(BlueprintCallable, Category = "HitReaction")
+		void AttackTrace(bool traceStart, int activeAttack);
+
+	UFUNCTION(Reliable, Server, WithValidation, Category = "HitReaction")
+		void ServerAttackTrace(bool traceStart, int activeAttack, float ClientTime);
+
+	//Skill sent to server
+	UFUNCTION(BlueprintCallable, Category = "HitReaction")
+		void FireTrace(int activeAttack);
+
+	UFUNCTION(Reliable, Server, WithValidation, Category = "HitReaction")
+		void ServerFireTrace(int activeAttack, float ClientTime);
+
+	//Server only, applies the attacker's damage through ApplyDamage
+	void DoDamage(AActor* HitActor);
+
+	FORCEINLINE float GetHealth() const { return Health; }
+	FORCEINLINE float GetBaseDamage() const { return BaseDamage; }
+	FORCEINLINE bool IsInRagdoll() const { return InRagdoll; }
+
+	//True while the counter moveset plays, hits then trigger a counter attack instead of damage
+	bool IsCountering() const;
+
+	//Whether the current attack already hit Target, each attack damages an actor once
+	bool HasDamaged(const AActor* Target) const { return ArrDamagedEnemy.Contains(Target); }
+
+	void AddDamaged(AActor* Target) { ArrDamagedEnemy.Add(Target); }
+
+	//Server only, turns Victim towards us and lets it counter this attack
+	void TriggerCounterAttack(ABattleMobaCharacter* Victim);
+
+	//Plays hit reactions from the moveset row the attacker used
+	void CopyHitMovesets(const ABattleMobaCharacter* Attacker);
+
+	//Socket the hit effect spawns at, set on this machine only
+	void SetLocalActiveSocket(FName SocketName) { ActiveSocket = SocketName; }
+
+	//Spawns HitEffect at ActiveSocket from the particle pool, nothing on a dedicated server
+	void SpawnHitEffect();
 
 	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
 		void UpdateHUD();
@@ -558,9 +611,6 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
 		void CreateCPHUD();
 
-	UFUNCTION(Reliable, NetMulticast, WithValidation, Category = "ReceiveDamage")
-		void TowerReceiveDamage(ADestructibleTower* Tower, float DamageApply);
-
 	/*******************SAFEZONE*****************************************/
 
 	void SafeZone(ABMobaTriggerCapsule* TriggerZone);
@@ -571,13 +621,16 @@ public:
 	UFUNCTION(NetMulticast, Unreliable, WithValidation)
 		void SafeZoneMulticast(ABMobaTriggerCapsule* TriggerZone);
 
-	/***********************CONTROL FLAG MODE*****************************/
-	void ControlFlagMode(ABattleMobaCTF* cf);
-
 	//Get skills from input touch combo
 	UFUNCTION(BlueprintCallable, Category = "ActionSkill")
 		void GetButtonSkillAction(FKey Currkeys, FString ButtonName, bool& cooldown, float& CooldownVal);
 
+	//Skill presses of every character, for tools watching input such as the load test recorder
+	static FMobaSkillButtonDelegate OnSkillButton;
+
 	UFUNCTION(BlueprintCallable, Category = "BattleStyle")
 		void ChooseBattleStyle(int style);
+
+	UFUNCTION(Reliable, Server, WithValidation, Category = "BattleStyle")
+		void ServerChooseBattleStyle(int style);
 };
\ No newline at end of file
@@ -60,6 +60,13 @@ protected:
 	UFUNCTION(Category = "Spawn")
 		void SpawnBasedOnTeam(FName TeamName, USkeletalMesh* CharMesh);
 
+	//Knocked-out pawn of each player waiting to be respawned in place
+	UPROPERTY()
+		TMap<AController*, ABattleMobaCharacter*> PooledPawns;
+
+	//Parked pawn of Controller if it can be reused for CharMesh, removed from the pool
+	ABattleMobaCharacter* TakePooledPawn(AController* Controller, USkeletalMesh* CharMesh);
+
 
 public:
 
@@ -80,6 +87,20 @@ public:
 
 	virtual void PostLogin(APlayerController* NewPlayer) override;
 
+	virtual void Logout(AController* Exiting) override;
+
+	//Unpossess the controller's pawn and keep it for its next respawn instead of destroying it
+	void ParkPawn(AController* Controller);
+
+	//Character class and meshes players spawn with, also used by the combat benchmark
+	TSubclassOf<ABattleMobaCharacter> GetSpawnedActor() const { return SpawnedActor; }
+
+	const TArray<USkeletalMesh*>& GetCharSelections() const { return CharSelections; }
+
+	//Times fresh spawns against pooled resets of the first player's pawn, possession excluded from both
+	UFUNCTION(Exec)
+		void MobaBenchRespawn(int32 Iterations = 50);
+
 	/*virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;*/
 
 	UFUNCTION(Reliable, Server, WithValidation, Category = "Respawn")
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "Net/UnrealNetwork.h"
+#include "MobaCosmeticChannel.h"
 #include "BattleMobaPC.generated.h"
 
 class ABattleMobaGameMode;
@@ -41,6 +42,10 @@ public:
 	UFUNCTION(Reliable, Server, WithValidation, Category = "Respawn")
 	void RespawnPawn(FTransform SpawnTransform);
 
+	//Cosmetic events of a server frame relevant to this player, losing one only costs a cosmetic
+	UFUNCTION(Unreliable, Client, Category = "Cosmetic")
+	void ClientCosmeticEvents(const FMobaCosmeticBatch& Batch);
+
 protected:
 	
 	//spectator pi
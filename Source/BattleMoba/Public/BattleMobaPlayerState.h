@@ -16,15 +16,22 @@ class BATTLEMOBA_API ABattleMobaPlayerState : public APlayerState
 	GENERATED_BODY()
 
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const;
+
+	virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack) override;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 	
 public:
 
 	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "Status")
 	float MaxHealth = 750.0f;
 
-	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "Status")
+	UPROPERTY(VisibleAnywhere, ReplicatedUsing = OnRep_TeamName, BlueprintReadWrite, Category = "Status")
 	FName TeamName;
 
+	UFUNCTION()
+	void OnRep_TeamName();
+
 	UPROPERTY(VisibleAnywhere, Replicated, BlueprintReadWrite, Category = "Status")
 	int32 Pi = 0;
 
@@ -56,6 +63,10 @@ public:
 		class UDataTable* ActionTable;
 
 public:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UFUNCTION(Reliable, Client, WithValidation, Category = "PI")
 		void SetPlayerIndex(int32 PlayerIndex);
 
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Engine/NetSerialization.h"
+#include "MobaCombatTraceBatcher.h"
+#include "CombatSubsystem.generated.h"
+
+class ABattleMobaCharacter;
+class ADestructibleTower;
+class UAnimMontage;
+
+//Side of the victim a hit came from, picks which of the attacker's hit movesets plays
+UENUM(BlueprintType)
+enum class EMobaHitDirection : uint8
+{
+	Special,
+	Front,
+	Back,
+	Left,
+	Right
+};
+
+//One hit taken by a character, everything else is resolved from the attacker on each client
+USTRUCT(BlueprintType)
+struct FMobaHitReaction : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "HitReaction")
+		class ABattleMobaCharacter* Attacker = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HitReaction")
+		EMobaHitDirection Direction = EMobaHitDirection::Special;
+
+	//Section index in the hit moveset
+	UPROPERTY(BlueprintReadOnly, Category = "HitReaction")
+		uint8 SectionId = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "HitReaction")
+		bool bKnockout = false;
+
+	//Bumped once per server frame with hits, wraps around
+	UPROPERTY()
+		uint8 Sequence = 0;
+};
+
+/**
+ * The last few hits of a character, replicated as a delta array. Old entries are overwritten in
+ * place, so a client that missed some updates only sees the newest ones and plays the latest.
+ */
+USTRUCT()
+struct FMobaHitReactionArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	static constexpr int32 Capacity = 4;
+
+	UPROPERTY()
+		TArray<FMobaHitReaction> Items;
+
+	//Slot for a new hit, overwriting the oldest once the buffer is full. Call MarkItemDirty after filling it
+	FMobaHitReaction& Push();
+
+	//Entry with the newest sequence, nullptr when empty
+	const FMobaHitReaction* GetLatest() const;
+
+	FMobaHitReaction* GetLatest() { return const_cast<FMobaHitReaction*>(static_cast<const FMobaHitReactionArray*>(this)->GetLatest()); }
+
+	//Drops every entry, sequences carry on so clients never mistake a new hit for one they played
+	void Reset();
+
+	//True if sequence A was issued after B, allowing for wrap-around
+	static bool IsNewer(uint8 A, uint8 B) { return int8(A - B) > 0; }
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FMobaHitReaction, FMobaHitReactionArray>(Items, DeltaParms, *this);
+	}
+
+private:
+
+	uint8 NextSequence = 0;
+
+	int32 OldestIndex = 0;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMobaHitReactionArray> : public TStructOpsTypeTraitsBase2<FMobaHitReactionArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Server-side combat queue. Hits found by the trace batcher during the frame are queued here and
+ * resolved once per tick in the order they arrived: damage, kill credit and hit reactions. The
+ * results reach clients through replicated properties on the victims, one net update per frame.
+ */
+UCLASS()
+class BATTLEMOBA_API UCombatSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	void QueueHit(ABattleMobaCharacter* Attacker, AActor* Target, EMobaCombatTraceKind Kind);
+
+	//Victims call this when their replicated state changed during the resolve pass
+	void MarkDirty(AActor* Actor);
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End of FTickableGameObject
+
+private:
+
+	struct FCombatHitEvent
+	{
+		TWeakObjectPtr<ABattleMobaCharacter> Attacker;
+
+		TWeakObjectPtr<AActor> Target;
+
+		EMobaCombatTraceKind Kind = EMobaCombatTraceKind::AttackTrace;
+	};
+
+	void ResolveCharacterHit(ABattleMobaCharacter* Attacker, ABattleMobaCharacter* Victim, EMobaCombatTraceKind Kind);
+
+	void ResolveTowerHit(ABattleMobaCharacter* Attacker, ADestructibleTower* Tower);
+
+	TArray<FCombatHitEvent> PendingHits;
+
+	TArray<TWeakObjectPtr<AActor>> DirtyActors;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "MobaWidgetBindings.h"
 #include "DestructibleTower.generated.h"
 
 UCLASS()
@@ -13,6 +14,10 @@ class BATTLEMOBA_API ADestructibleTower : public AActor
 
 		//Replicated Network setup
 		void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+		virtual bool CallRemoteFunction(UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack) override;
+
+		virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 	
 public:	
 	// Sets default values for this actor's properties
@@ -20,6 +25,8 @@ public:
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	
 protected:
@@ -45,6 +52,9 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = UI)
 		class UUserWidget* W_DisplayHealth;
 
+	//		Cached HealthText and TeamName of W_DisplayHealth
+	FMobaWidgetBinding HealthWidget;
+
 	UPROPERTY(EditAnywhere, Category = Materials)
 		class UMaterialInterface* Material1;
 
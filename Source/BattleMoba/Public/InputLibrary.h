@@ -41,9 +41,6 @@ struct FActionSkill : public FTableRowBase
 {
 	GENERATED_BODY()
 
-	UPROPERTY()
-		bool isOnCD = false;
-
 	//If cooldown mechanic is applied
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cooldown")
 		bool IsUsingCD = false;
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MobaCombatBenchCommandlet.generated.h"
+
+/**
+ * Network free combat baseline. Spawns -Characters=<n> characters (20) of the game mode's character class
+ * on a flat arena in a standalone world, splits them into Radiant and Dire and lets them fight: skill presses,
+ * attack traces, damage, knockouts and pooled respawns. The world is ticked at a fixed -Fps=<f> (30) for
+ * -Seconds=<s> (60) of simulated time from -Seed=<n> (1), and the run reports mean and p99 game thread ms per
+ * frame, traces per second and allocations per frame, also written as one CSV line to -Report=<file>.
+ *
+ * UE4Editor-Cmd BattleMoba.uproject -run=MobaCombatBench -nullrhi -nosound -unattended
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaCombatBenchCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UMobaCombatBenchCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//Combat trace log, compiled out of Shipping builds unless a target defines MOBA_COMBAT_LOG=1
+#ifndef MOBA_COMBAT_LOG
+	#define MOBA_COMBAT_LOG !UE_BUILD_SHIPPING
+#endif
+
+enum class EMobaCombatEvent : uint8
+{
+	//Int: touch index, A/B: screen location
+	SwipeInput,
+	//A/B: world direction fed to AddMovementInput
+	MoveInput,
+	//Int: active attack, A: anim instance allows attacking, B: hit trace applies
+	FireTrace,
+	//Int: active attack, A: trace starts
+	AttackTrace,
+	//Int: skill index
+	SkillOnCooldown,
+	//A: move speed towards the target
+	RotateToTarget,
+	//Int: EMobaHitDirection, A: damage
+	HitReceived,
+	//Int: EMobaCombatTraceKind, A: victim health after the hit
+	HitResolved,
+	//A: health, B: max health
+	HealthChanged,
+	//A: damage the attacker applies
+	DamageApplied,
+
+	Count
+};
+
+#if MOBA_COMBAT_LOG
+
+/**
+ * Fixed size binary records kept in one lock-free ring per writing thread. Writing copies a few words and
+ * never formats; text is only produced by Dump, from Moba.CombatLog.Dump or when the process crashes.
+ * Sources are stored by object index and serial number and resolved to names at dump time, if they still exist.
+ */
+struct BATTLEMOBA_API FMobaCombatLog
+{
+	static void Write(EMobaCombatEvent Type, const UObject* Source, int32 Int = 0, float A = 0.0f, float B = 0.0f);
+
+	//Formats every ring oldest first into Filename, or a timestamped file in the log directory, and returns its path
+	static FString Dump(const FString& Filename = FString());
+};
+
+#define MOBA_COMBAT_EVENT(Type, Source, ...) FMobaCombatLog::Write(EMobaCombatEvent::Type, Source, ##__VA_ARGS__)
+
+#else
+
+#define MOBA_COMBAT_EVENT(Type, Source, ...)
+
+#endif
@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "MobaCombatTraceBatcher.generated.h"
+
+class ABattleMobaCharacter;
+
+enum class EMobaCombatTraceKind : uint8
+{
+	//Animation driven AttackTrace, every enemy along the limb is hit
+	AttackTrace,
+	//Skill driven FireTrace, only the first enemy takes the hit
+	FireTrace,
+};
+
+/**
+ * Gathers the attack probes of every character during a frame and submits them as async sweeps.
+ * The results come back at the start of the next frame and are handed to the attackers in one pass,
+ * in the order the attacks were queued. Only used on the server.
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaCombatTraceBatcher : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	//Queue an attack slot trace, RewindTime is the server time the attacker saw when attacking
+	void QueueAttack(ABattleMobaCharacter* Attacker, EMobaCombatTraceKind Kind, int32 ActiveAttack, float RewindTime);
+
+	/**		Sweep an attack slot every frame from where its volumes were on the previous frame until disarmed, false if it already was*/
+	bool ArmAttack(ABattleMobaCharacter* Attacker, int32 ActiveAttack, float RewindTime);
+
+	void DisarmAttack(ABattleMobaCharacter* Attacker);
+
+	//Sweeps submitted since the world started, for benchmarks in builds without stats
+	int64 GetTotalQueries() const { return TotalQueries; }
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End of FTickableGameObject
+
+private:
+
+	//One box sweep of a hitbox volume, as seen by the attacker
+	struct FCombatQuery
+	{
+		int32 RequestIndex = INDEX_NONE;
+
+		FVector Start;
+
+		FVector End;
+
+		FQuat Rotation;
+
+		FVector Extent;
+	};
+
+	struct FCombatRequest
+	{
+		TWeakObjectPtr<ABattleMobaCharacter> Attacker;
+
+		EMobaCombatTraceKind Kind = EMobaCombatTraceKind::AttackTrace;
+
+		int32 ActiveAttack = 0;
+
+		float RewindTime = 0.0f;
+
+		TArray<FHitResult> Hits;
+	};
+
+	//Attack slot swept once per frame between AttackTrace start and end
+	struct FArmedAttack
+	{
+		TWeakObjectPtr<ABattleMobaCharacter> Attacker;
+
+		int32 ActiveAttack = 0;
+
+		//How far behind the server the attacker was when arming, kept for every sweep of the attack
+		float RewindDelay = 0.0f;
+
+		float ArmedTime = 0.0f;
+
+		//Volume centers of the previous sweep, empty before the first one
+		TArray<FVector, TInlineAllocator<2>> PreviousCenters;
+	};
+
+	//Adds a request and its queries, PreviousCenters replaces the forward sweep when it matches the volume count
+	void AddRequest(ABattleMobaCharacter* Attacker, EMobaCombatTraceKind Kind, int32 ActiveAttack, float RewindTime, TArray<FVector, TInlineAllocator<2>>* PreviousCenters);
+
+	void QueueArmedSweeps();
+
+	//Async sweeps for every queued query, grown by the lag compensation slack
+	void SubmitPending();
+
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	//Narrow phase of every broad phase hit, then hand the results to the attackers
+	void ResolveInFlight();
+
+	TArray<FArmedAttack> ArmedAttacks;
+
+	TArray<FCombatRequest> PendingRequests;
+
+	TArray<FCombatQuery> PendingQueries;
+
+	TArray<FCombatRequest> InFlightRequests;
+
+	TArray<FCombatQuery> InFlightQueries;
+
+	//Broad phase hits per in flight query
+	TArray<TArray<FHitResult>> InFlightHits;
+
+	int32 OutstandingTraces = 0;
+
+	int64 TotalQueries = 0;
+
+	FTraceDelegate TraceDelegate;
+};
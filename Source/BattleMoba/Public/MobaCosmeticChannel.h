@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "MobaCosmeticChannel.generated.h"
+
+class ABattleMobaCharacter;
+class APlayerController;
+
+//Hit effect spawned at the emitter's active socket
+USTRUCT()
+struct FMobaEffectEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		ABattleMobaCharacter* EmitActor = nullptr;
+};
+
+//Latest rotation of a character during the frame
+USTRUCT()
+struct FMobaRotationEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		ABattleMobaCharacter* Character = nullptr;
+
+	UPROPERTY()
+		FRotator Rotation = FRotator::ZeroRotator;
+};
+
+//Latest active socket of a character during the frame
+USTRUCT()
+struct FMobaSocketEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		ABattleMobaCharacter* Character = nullptr;
+
+	UPROPERTY()
+		FName SocketName;
+};
+
+//Cosmetic events of one server frame, as sent to one connection
+USTRUCT()
+struct FMobaCosmeticBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TArray<FMobaSocketEvent> Sockets;
+
+	UPROPERTY()
+		TArray<FMobaRotationEvent> Rotations;
+
+	UPROPERTY()
+		TArray<FMobaEffectEvent> Effects;
+
+	bool IsEmpty() const { return Sockets.Num() == 0 && Rotations.Num() == 0 && Effects.Num() == 0; }
+
+	//Sockets first so effects of the same batch spawn at the new socket
+	void Apply() const;
+};
+
+/**
+ * Server-side channel for purely cosmetic events: hit effects, snapped rotations and active sockets.
+ * Events are applied on the server straight away, gathered for the rest of the frame with repeated
+ * rotations and sockets coalesced to the latest value, then sent to each connection as one
+ * unreliable batch holding only the events whose character is relevant to that connection.
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaCosmeticChannel : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	void QueueEffect(ABattleMobaCharacter* EmitActor);
+
+	void QueueRotation(ABattleMobaCharacter* Character, const FRotator& Rotation);
+
+	void QueueActiveSocket(ABattleMobaCharacter* Character, FName SocketName);
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End of FTickableGameObject
+
+private:
+
+	//Events of the frame for every connection, filtered per connection on flush
+	FMobaCosmeticBatch Pending;
+
+	//Index into Pending of each character's rotation and socket, so later values overwrite earlier ones
+	TMap<TWeakObjectPtr<ABattleMobaCharacter>, int32> RotationIndex;
+
+	TMap<TWeakObjectPtr<ABattleMobaCharacter>, int32> SocketIndex;
+
+	void BuildBatchFor(APlayerController* PC, FMobaCosmeticBatch& OutBatch) const;
+
+	void Flush();
+};
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "MobaHitboxSet.generated.h"
+
+class USkeletalMeshComponent;
+
+//Single attack probe, placed relative to a mesh socket
+USTRUCT(BlueprintType)
+struct FMobaHitboxProbe
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox")
+		FName SocketName;
+
+	//Offset from the socket origin, in socket space
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox")
+		FVector LocalOffset = FVector::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox")
+		FVector Extent = FVector(3.0f, 5.0f, 5.0f);
+};
+
+//All probes evaluated together for one attack slot (left punch, right kick...)
+USTRUCT(BlueprintType)
+struct FMobaHitboxSlot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox")
+		FName SlotName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hitbox")
+		TArray<FMobaHitboxProbe> Probes;
+};
+
+//Probes of a slot that share a socket, merged into one oriented box in socket space
+struct FMobaHitboxVolume
+{
+	FName SocketName;
+
+	FVector LocalCenter = FVector::ZeroVector;
+
+	FVector LocalExtent = FVector::ZeroVector;
+
+	//Resolve the volume against the current pose of the mesh
+	void GetWorldBox(const USkeletalMeshComponent* Mesh, FVector& OutCenter, FQuat& OutRotation, FVector& OutExtent) const;
+};
+
+/**
+ * Data-driven limb hitboxes. Attack slots are indexed the same way as the activeAttack
+ * argument of AttackTrace (1 = left punch, 2 = right punch, 3 = left kick, 4 = right kick).
+ */
+UCLASS(BlueprintType)
+class BATTLEMOBA_API UMobaHitboxSet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hitbox")
+		TArray<FMobaHitboxSlot> AttackSlots;
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	//Merged volumes of an attack slot, nullptr if the slot does not exist
+	const TArray<FMobaHitboxVolume>* GetSlotVolumes(int32 ActiveAttack) const;
+
+	//Built-in layout matching the limb colliders the character used to create
+	static const TArray<FMobaHitboxVolume>* GetDefaultSlotVolumes(int32 ActiveAttack);
+
+	static void CompileSlots(const TArray<FMobaHitboxSlot>& Slots, TArray<TArray<FMobaHitboxVolume>>& OutVolumes);
+
+private:
+
+	TArray<TArray<FMobaHitboxVolume>> CompiledSlots;
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+class ABattleMobaCharacter;
+
+//Hurtbox transform of a character at a given server time
+struct FMobaPoseSample
+{
+	float Time = -1.0f;
+
+	FTransform MeshTransform = FTransform::Identity;
+};
+
+/**
+ * Fixed-size ring buffer of the recent hurtbox transforms of one character, written once per
+ * server tick. Capacity * sizeof(FMobaPoseSample) is the whole memory cost (about 2 KB per character).
+ */
+struct BATTLEMOBA_API FMobaPoseHistory
+{
+	//32 samples covers about half a second at 60Hz and a full second at 30Hz
+	static constexpr int32 Capacity = 32;
+
+	void Record(float Time, const FTransform& MeshTransform);
+
+	//Interpolated transform at Time, false if Time is newer than the latest sample or nothing was recorded
+	bool Sample(float Time, FTransform& OutTransform) const;
+
+	void Reset();
+
+	int32 Num() const { return Count; }
+
+private:
+
+	const FMobaPoseSample& GetSample(int32 AgeIndex) const;
+
+	FMobaPoseSample Samples[Capacity];
+
+	//		index of the next slot to write
+	int32 Head = 0;
+
+	int32 Count = 0;
+};
+
+/**
+ * Server-side rewind helpers. Attack queries run against the current scene, so instead of moving
+ * targets back in time the query is moved forward: a shape swept against the rewound pose of a
+ * character is the same as that shape, carried by the correction transform, swept against its current pose.
+ */
+struct BATTLEMOBA_API FMobaLagCompensation
+{
+	static bool IsEnabled();
+
+	//Clamp a client timestamp into the window the server is willing to rewind
+	static float ClampRewindTime(UWorld* World, float ClientTime);
+
+	//How far broad phase queries are grown so targets that have moved since RewindTime are still found
+	static float GetBroadphaseSlack();
+
+	//Maps world space at RewindTime onto the current mesh pose of Target, false when no rewind is needed
+	static bool GetRewindCorrection(const ABattleMobaCharacter* Target, float RewindTime, FTransform& OutCorrection);
+};
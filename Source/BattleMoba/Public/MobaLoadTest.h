@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "InputCoreTypes.h"
+#include "Math/RandomStream.h"
+#include "MobaLoadTest.generated.h"
+
+class ABattleMobaCharacter;
+
+/**
+ * Load testing a dedicated server without devices, driven from the command line. Scripts/LoadTest.sh runs it end to end.
+ * -MobaBot: a headless client (-nullrhi -nosound) plays its possessed character. -MobaBotScript=<file> replays
+ * a script, otherwise it walks between flags, wanders and presses random skills seeded by -MobaBotSeed=<n>.
+ * -MobaBotRecord=<file>: a normal client writes the local player's inputs as a script.
+ * -MobaLoadTest=<n>: a dedicated server turns on net accounting, waits for n players, captures a CSV profile
+ * for -MobaLoadTestSeconds=<s>, writes NetAccounting-<n>.csv to the log directory and quits.
+ *
+ * Script lines, run in order and from the top again at the end:
+ *   move <x> <y> <seconds>		world direction
+ *   wait <seconds>
+ *   skill <key> <button>		as pressed through GetButtonSkillAction
+ *   flag <index>				walk to a flag of the world registry
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaLoadTest : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	static UMobaLoadTest* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	// End of FTickableGameObject
+
+private:
+
+	enum class ECommand : uint8
+	{
+		Move,
+		Wait,
+		Skill,
+		Flag
+	};
+
+	struct FCommand
+	{
+		ECommand Type = ECommand::Wait;
+
+		FVector2D Direction = FVector2D::ZeroVector;
+
+		float Duration = 0.0f;
+
+		FKey Key;
+
+		FString Button;
+
+		int32 Flag = 0;
+	};
+
+	enum class EServerPhase : uint8
+	{
+		Off,
+		WaitingForPlayers,
+		Capturing,
+		Exiting
+	};
+
+	ABattleMobaCharacter* GetLocalCharacter() const;
+
+	bool LoadScript(const FString& Path);
+
+	//Appends a random round of commands, for bots without a script
+	void AddRandomCommands(const ABattleMobaCharacter* Character);
+
+	void TickBot(float DeltaTime);
+
+	void TickRecord(float DeltaTime);
+
+	void TickServer();
+
+	//Writes the movement held since RecordSince as one line
+	void FlushRecordedMove();
+
+	//Bound to ABattleMobaCharacter::OnSkillButton while recording, keeps the local player's presses
+	void RecordSkill(ABattleMobaCharacter* Character, const FKey& Key, const FString& ButtonName);
+
+	//Bot
+	bool bBot = false;
+
+	bool bScripted = false;
+
+	TArray<FCommand> Commands;
+
+	int32 Cursor = 0;
+
+	float CommandTime = 0.0f;
+
+	FRandomStream Random;
+
+	//Recorder
+	FString RecordPath;
+
+	TArray<FString> RecordLines;
+
+	FVector2D RecordDirection = FVector2D::ZeroVector;
+
+	float RecordTime = 0.0f;
+
+	float RecordSince = 0.0f;
+
+	FDelegateHandle SkillButtonHandle;
+
+	//Server
+	EServerPhase ServerPhase = EServerPhase::Off;
+
+	int32 ExpectedPlayers = 0;
+
+	float CaptureSeconds = 60.0f;
+
+	double PhaseEndTime = 0.0;
+};
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "MobaNameplateOcclusion.generated.h"
+
+class UWidgetComponent;
+
+/**
+ * Hides nameplates the local camera cannot see. Every frame at most Moba.Nameplate.TracesPerFrame
+ * async box sweeps are issued from nameplates towards the camera, picking the ones that waited longest
+ * weighted by their size on screen, so the cost follows the budget instead of the player count.
+ * A nameplate only changes visibility after Moba.Nameplate.Hysteresis results in a row agree.
+ * Not created on dedicated servers.
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaNameplateOcclusion : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	//Start tracing Widget, Owner is ignored by the sweep
+	void Track(UWidgetComponent* Widget, AActor* Owner);
+
+	//Stop tracing Widget, it keeps its current visibility
+	void Untrack(UWidgetComponent* Widget);
+
+	//Trace Widget in the next frame ahead of the others
+	void Refresh(UWidgetComponent* Widget);
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End of FTickableGameObject
+
+private:
+
+	struct FNameplate
+	{
+		TWeakObjectPtr<UWidgetComponent> Widget;
+
+		TWeakObjectPtr<AActor> Owner;
+
+		//Grows every frame by the nameplate's screen size, the highest ones are traced first
+		float Urgency = 0.0f;
+
+		//Results in a row that disagree with the current visibility
+		int32 Streak = 0;
+
+		bool bPending = false;
+	};
+
+	void OnTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	uint32 FindSerial(const UWidgetComponent* Widget) const;
+
+	//Keyed by a serial passed to the sweep as user data
+	TMap<uint32, FNameplate> Nameplates;
+
+	uint32 NextSerial = 1;
+
+	FTraceDelegate TraceDelegate;
+};
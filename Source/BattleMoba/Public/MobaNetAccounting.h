@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/CoreNetTypes.h"
+#include "Engine/EngineTypes.h"
+#include "MobaNetAccounting.generated.h"
+
+class UNetConnection;
+class UProperty;
+
+/**
+ * Opt-in bandwidth accounting, enabled with Moba.Net.Accounting 1. Actors report the RPCs they send
+ * from CallRemoteFunction and their changed replicated properties from PreReplication, and every send
+ * is summed per connection as call count, estimated payload bytes and reliability. Sizes come from
+ * FMobaNetSizeEstimator and leave out bunch and packet headers.
+ * The server sees its Client and NetMulticast RPCs and all property traffic, a client sees its own Server RPCs.
+ * WriteReport dumps the totals as a CSV sorted by bytes at match end, or when the world goes away without one.
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaNetAccounting : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	//The subsystem of the world of WorldContextObject, nullptr while accounting is off
+	static UMobaNetAccounting* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+
+	//From CallRemoteFunction, charges Function to every connection it is sent on
+	void RecordRpc(AActor* Actor, UFunction* Function, void* Parameters);
+
+	//From PreReplication, charges the properties changed since the last net update to every connection with a channel for Actor
+	void RecordProperties(AActor* Actor);
+
+	//What an actor's CallRemoteFunction and PreReplication overrides call, nothing while accounting is off
+	static void RecordRpcFor(AActor* Actor, UFunction* Function, void* Parameters);
+
+	static void RecordPropertiesFor(AActor* Actor);
+
+	//Writes the totals to Filename, or a timestamped file in the log directory, and returns its path
+	FString WriteReport(const FString& Filename = FString());
+
+private:
+
+	struct FRowKey
+	{
+		int32 Connection;
+		FName Owner;
+		FName Member;
+
+		bool operator==(const FRowKey& Other) const
+		{
+			return Connection == Other.Connection && Owner == Other.Owner && Member == Other.Member;
+		}
+
+		friend uint32 GetTypeHash(const FRowKey& Key)
+		{
+			return HashCombine(HashCombine(::GetTypeHash(Key.Connection), GetTypeHash(Key.Owner)), GetTypeHash(Key.Member));
+		}
+	};
+
+	struct FRow
+	{
+		bool bRpc = false;
+		bool bReliable = false;
+		int64 Count = 0;
+		int64 Bits = 0;
+	};
+
+	struct FTrackedProperty
+	{
+		const UProperty* Property = nullptr;
+
+		ELifetimeCondition Condition = COND_None;
+
+		//Offset of the copy inside an actor's shadow block
+		int32 Offset = 0;
+	};
+
+	//Replicated properties of one class and the layout of the shadow copy kept per actor
+	struct FClassLayout
+	{
+		TArray<FTrackedProperty> Properties;
+
+		int32 Size = 0;
+
+		int32 Alignment = 1;
+	};
+
+	//Property values as of the last net update, and the connections that had a channel then
+	struct FShadow
+	{
+		const FClassLayout* Layout = nullptr;
+
+		uint8* Data = nullptr;
+
+		TArray<TObjectKey<UNetConnection>> Channels;
+	};
+
+	const FClassLayout& GetLayout(const UClass* Class);
+
+	int32 GetConnectionIndex(UNetConnection* Connection);
+
+	void Charge(UNetConnection* Connection, FName Owner, FName Member, bool bRpc, bool bReliable, int64 Bits);
+
+	void FreeShadow(FShadow& Shadow);
+
+	UFUNCTION()
+		void OnActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	TMap<FRowKey, FRow> Rows;
+
+	TMap<TObjectKey<UNetConnection>, int32> ConnectionIndices;
+
+	//Name of every connection seen, by index, kept after it closes
+	TArray<FString> ConnectionNames;
+
+	TMap<const UClass*, TUniquePtr<FClassLayout>> Layouts;
+
+	TMap<TObjectKey<AActor>, FShadow> Shadows;
+
+	bool bReportWritten = false;
+};
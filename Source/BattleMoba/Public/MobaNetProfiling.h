@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UFunction;
+class UProperty;
+class UScriptStruct;
+
+/**
+ * Estimates how many bits values cost when serialized into an RPC. Object references are counted
+ * as one packed NetGUID, which is what an already acknowledged asset costs.
+ */
+struct BATTLEMOBA_API FMobaNetSizeEstimator
+{
+	static int64 EstimatePropertyBits(const UProperty* Property, const void* ValuePtr);
+
+	static int64 EstimateStructBits(const UScriptStruct* Struct, const void* StructData);
+
+	//Parameters of an RPC laid out in Params, including the per-parameter send bit
+	static int64 EstimateFunctionBits(const UFunction* Function, const void* Params);
+
+	//Bits of a packed NetGUID for an acknowledged object
+	static constexpr int64 ObjectReferenceBits = 32;
+};
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MobaParticlePool.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+struct FMobaSkillIndex;
+
+//Components of one particle system, reused in the order they were last activated
+USTRUCT()
+struct FMobaParticlePoolEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TArray<UParticleSystemComponent*> Components;
+
+	//World time each component was last activated, parallel to Components
+	TArray<float> ActivatedAt;
+};
+
+/**
+ * Per-world pool of one-shot particle components keyed by particle system. A spawn reuses a finished
+ * component of the same system, adds one while under Moba.ParticlePool.MaxPerSystem, and otherwise
+ * restarts the one activated longest ago. Not created on dedicated servers.
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaParticlePool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	UParticleSystemComponent* Spawn(UParticleSystem* Template, const FVector& Location, const FRotator& Rotation);
+
+	//Create components for Template up front, up to Count or the cap
+	void Prewarm(UParticleSystem* Template, int32 Count);
+
+	//Prewarm the hit impact of every skill in the index
+	void PrewarmSkills(const FMobaSkillIndex& Skills);
+
+	//Spawn through the world's pool, falling back to a plain emitter spawn when there is none
+	static UParticleSystemComponent* SpawnEmitter(UWorld* World, UParticleSystem* Template, const FVector& Location, const FRotator& Rotation);
+
+private:
+
+	UPROPERTY()
+		TMap<UParticleSystem*, FMobaParticlePoolEntry> Pools;
+
+	UParticleSystemComponent* CreateComponent(UParticleSystem* Template, FMobaParticlePoolEntry& Entry);
+};
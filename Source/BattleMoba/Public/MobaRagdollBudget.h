@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "MobaRagdollBudget.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ * Caps how many knocked-out meshes simulate at once. A granted ragdoll simulates until it settles or
+ * Moba.Ragdoll.MaxSimTime passes, then its bodies are put to sleep and its slot freed. When every
+ * slot is busy the oldest ragdoll is put to sleep early. Meshes farther than Moba.Ragdoll.MaxDistance
+ * from the local camera are refused, and the caller shows a death pose instead.
+ * Not created on dedicated servers, which only need the knocked-out state.
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaRagdollBudget : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	//Start simulating Mesh if the budget allows it, false if the caller should fall back to a pose
+	bool RequestRagdoll(USkeletalMeshComponent* Mesh);
+
+	//Drop Mesh from the budget, for meshes going away while simulating
+	void ReleaseRagdoll(USkeletalMeshComponent* Mesh);
+
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End of FTickableGameObject
+
+private:
+
+	struct FActiveRagdoll
+	{
+		TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+		float StartTime = 0.0f;
+
+		//Time the mesh first moved slower than the settle speed, negative while moving
+		float SlowSince = -1.0f;
+	};
+
+	//Oldest first
+	TArray<FActiveRagdoll> Active;
+
+	static void Sleep(USkeletalMeshComponent* Mesh);
+};
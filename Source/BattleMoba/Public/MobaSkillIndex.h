@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+#include "InputLibrary.h"
+
+class UDataTable;
+
+//One section of a combo skill, resolved against the skill montage when the index is built
+struct FMobaComboStep
+{
+	FName Section;
+
+	//Section index in the montage, what ServerExecuteAction sends
+	uint8 SectionId = 0;
+
+	float Length = 0.0f;
+};
+
+//Sections NormalAttack01..NormalAttack0N of a UseSection skill, played in order and wrapping around
+struct FMobaComboGraph
+{
+	TArray<FMobaComboStep> Steps;
+};
+
+/**
+ * Flat view of a skill DataTable built once when the table is assigned, so a button press is a
+ * hash lookup instead of a walk over every row. Index order is the table's row order.
+ */
+struct BATTLEMOBA_API FMobaSkillIndex
+{
+	//Index 255 is left free as an invalid marker
+	static constexpr int32 MaxSkills = MAX_uint8;
+
+	void Build(UDataTable* Table);
+
+	void Reset();
+
+	bool IsBuiltFor(const UDataTable* Table) const { return Table != nullptr && Table == SourceTable.Get(); }
+
+	//First skill bound to Key or ButtonName, same match order as the table rows, INDEX_NONE if none
+	int32 Find(const FKey& Key, const FString& ButtonName) const;
+
+	int32 Num() const { return Skills.Num(); }
+
+	FActionSkill* GetSkill(int32 SkillIndex) const { return Skills.IsValidIndex(SkillIndex) ? Skills[SkillIndex] : nullptr; }
+
+	FName GetRowName(int32 SkillIndex) const { return RowNames.IsValidIndex(SkillIndex) ? RowNames[SkillIndex] : NAME_None; }
+
+	//Combo of a UseSection skill, nullptr for other skills or when none of its sections exist
+	const FMobaComboGraph* GetCombo(int32 SkillIndex) const { return (Combos.IsValidIndex(SkillIndex) && Combos[SkillIndex].Steps.Num() > 0) ? &Combos[SkillIndex] : nullptr; }
+
+private:
+
+	TWeakObjectPtr<UDataTable> SourceTable;
+
+	//Rows of SourceTable, owned by the table
+	TArray<FActionSkill*> Skills;
+
+	TArray<FName> RowNames;
+
+	//Parallel to Skills
+	TArray<FMobaComboGraph> Combos;
+
+	TMap<FKey, int32> KeyToSkill;
+
+	TMap<FString, int32> ButtonToSkill;
+
+	static void BuildCombo(const FActionSkill& Skill, FMobaComboGraph& OutCombo);
+};
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UUserWidget;
+class UWidgetComponent;
+class UTextBlock;
+class UProgressBar;
+
+/**
+ * View-model of one world-space widget. The value text, team text and progress bar are looked up by
+ * name once per widget instance, and the setters only write to Slate when the shown value changes.
+ */
+struct BATTLEMOBA_API FMobaWidgetBinding
+{
+	FMobaWidgetBinding() {}
+
+	FMobaWidgetBinding(FName InValueTextName, FName InBarName, FName InTeamTextName = NAME_None);
+
+	//Resolves the named children of InWidget, only when it is not the widget already bound
+	bool Bind(UUserWidget* InWidget);
+
+	bool Bind(UWidgetComponent* Component);
+
+	bool IsBound() const { return Widget.IsValid(); }
+
+	//Shown as a whole number in the value text
+	void SetValue(float Value);
+
+	void SetPercent(float Percent);
+
+	//Fill colour of the bar and colour of the value text
+	void SetColor(const FLinearColor& Color);
+
+	void SetTeam(FName Team);
+
+	//Current fill of the bar, 0 when there is none
+	float GetPercent() const;
+
+private:
+
+	void ResetCache();
+
+	FName ValueTextName;
+
+	FName BarName;
+
+	FName TeamTextName;
+
+	TWeakObjectPtr<UUserWidget> Widget;
+
+	TWeakObjectPtr<UTextBlock> ValueText;
+
+	TWeakObjectPtr<UTextBlock> TeamText;
+
+	TWeakObjectPtr<UProgressBar> Bar;
+
+	//Last values written to Slate
+	int32 ShownValue = MIN_int32;
+
+	float ShownPercent = -1.0f;
+
+	FLinearColor ShownColor = FLinearColor(0.0f, 0.0f, 0.0f, -1.0f);
+
+	FName ShownTeam;
+
+	bool bHasTeam = false;
+};
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Components/SlateWrapperTypes.h"
+#include "MobaWidgetBindings.h"
+#include "MobaWidgetManager.generated.h"
+
+class UWidgetComponent;
+class UUserWidget;
+
+/**
+ * Central owner of the world-space widgets of the local client. Registered widgets are re-evaluated every
+ * Moba.Widget.EvaluateInterval: beyond Moba.Widget.CullDistance or off-screen they are collapsed and stop
+ * ticking, beyond Moba.Widget.ThrottleDistance they tick every Moba.Widget.ThrottleInterval.
+ * Also pools the floating damage numbers. Not created on dedicated servers.
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaWidgetManager : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	void RegisterWidget(UWidgetComponent* Widget);
+
+	//Restores the widget before letting it go
+	void UnregisterWidget(UWidgetComponent* Widget);
+
+	//Floats Value up from WorldLocation for Moba.FloatingText.Lifetime, using a pooled widget of Class with a ValueText block
+	void ShowFloatingText(TSubclassOf<UUserWidget> Class, const FVector& WorldLocation, float Value);
+
+	int32 GetActiveCount() const { return NumActive; }
+
+	int32 GetThrottledCount() const { return NumThrottled; }
+
+	int32 GetCulledCount() const { return NumCulled; }
+
+	int32 GetFloatingTextCount() const { return FloatingWidgets.Num(); }
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End of FTickableGameObject
+
+private:
+
+	enum class EWidgetState : uint8
+	{
+		Active,
+		Throttled,
+		Culled
+	};
+
+	struct FManagedWidget
+	{
+		TWeakObjectPtr<UWidgetComponent> Widget;
+
+		EWidgetState State = EWidgetState::Active;
+
+		//Visibility of the user widget before it was collapsed
+		ESlateVisibility VisibleAs = ESlateVisibility::SelfHitTestInvisible;
+	};
+
+	struct FFloatingText
+	{
+		TSubclassOf<UUserWidget> Class;
+
+		FMobaWidgetBinding Binding;
+
+		FVector Location = FVector::ZeroVector;
+
+		float StartTime = 0.0f;
+
+		bool bLive = false;
+	};
+
+	void Evaluate();
+
+	void SetState(FManagedWidget& Managed, EWidgetState State);
+
+	void TickFloatingTexts();
+
+	TArray<FManagedWidget> Widgets;
+
+	float NextEvaluateTime = 0.0f;
+
+	int32 NumActive = 0;
+
+	int32 NumThrottled = 0;
+
+	int32 NumCulled = 0;
+
+	//Every floating text widget created, parallel to FloatingTexts
+	UPROPERTY()
+		TArray<UUserWidget*> FloatingWidgets;
+
+	TArray<FFloatingText> FloatingTexts;
+
+	int32 NumLiveTexts = 0;
+};
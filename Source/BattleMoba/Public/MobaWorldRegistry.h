@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MobaWorldRegistry.generated.h"
+
+class ABattleMobaCharacter;
+class ABattleMobaPlayerState;
+class ABattleMobaCTF;
+class ADestructibleTower;
+class ABMobaTriggerCapsule;
+class ABattleMobaGameMode;
+class ABattleMobaGameState;
+
+//Live objects of one type, also split by team. Objects add themselves on BeginPlay and leave on EndPlay
+template<typename T>
+struct TMobaTeamList
+{
+	//Radiant, Dire, then anything without a team
+	static constexpr int32 NumTeams = 3;
+
+	static int32 TeamIndex(FName Team)
+	{
+		static const FName Radiant("Radiant");
+		static const FName Dire("Dire");
+		return Team == Radiant ? 0 : (Team == Dire ? 1 : 2);
+	}
+
+	TArray<T*> All;
+
+	TArray<T*> Teams[NumTeams];
+
+	TMap<const T*, int32> TeamOf;
+
+	void Add(T* Object, FName Team)
+	{
+		if (TeamOf.Contains(Object))
+		{
+			SetTeam(Object, Team);
+			return;
+		}
+
+		const int32 Index = TeamIndex(Team);
+		All.Add(Object);
+		Teams[Index].Add(Object);
+		TeamOf.Add(Object, Index);
+	}
+
+	void Remove(T* Object)
+	{
+		int32 Index = INDEX_NONE;
+		if (TeamOf.RemoveAndCopyValue(Object, Index))
+		{
+			All.RemoveSingleSwap(Object, false);
+			Teams[Index].RemoveSingleSwap(Object, false);
+		}
+	}
+
+	void SetTeam(T* Object, FName Team)
+	{
+		int32* Current = TeamOf.Find(Object);
+		const int32 Index = TeamIndex(Team);
+		if (Current != nullptr && *Current != Index)
+		{
+			Teams[*Current].RemoveSingleSwap(Object, false);
+			Teams[Index].Add(Object);
+			*Current = Index;
+		}
+	}
+
+	void Reset()
+	{
+		All.Reset();
+		for (TArray<T*>& Team : Teams)
+		{
+			Team.Reset();
+		}
+		TeamOf.Reset();
+	}
+};
+
+/**
+ * Typed, team-partitioned lists of the gameplay actors in the world, so gameplay code never has to
+ * iterate the world to find characters, player states, flags, towers or safe zones.
+ */
+UCLASS()
+class BATTLEMOBA_API UMobaWorldRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	static UMobaWorldRegistry* Get(const UObject* WorldContextObject);
+
+	template<typename T>
+	void Register(T* Object, FName Team) { if (Object) { GetList<T>().Add(Object, Team); } }
+
+	template<typename T>
+	void Unregister(T* Object) { GetList<T>().Remove(Object); }
+
+	//Move an already registered object to its new team
+	template<typename T>
+	void SetTeam(T* Object, FName Team) { GetList<T>().SetTeam(Object, Team); }
+
+	template<typename T>
+	const TArray<T*>& GetAll() const { return const_cast<UMobaWorldRegistry*>(this)->GetList<T>().All; }
+
+	//Objects of Team, NAME_None for those without a team
+	template<typename T>
+	const TArray<T*>& GetTeam(FName Team) const { return const_cast<UMobaWorldRegistry*>(this)->GetList<T>().Teams[TMobaTeamList<T>::TeamIndex(Team)]; }
+
+	//Authority game mode, nullptr on clients
+	ABattleMobaGameMode* GetGameMode() const;
+
+	ABattleMobaGameState* GetGameState() const;
+
+	virtual void Deinitialize() override;
+
+private:
+
+	template<typename T>
+	TMobaTeamList<T>& GetList();
+
+	TMobaTeamList<ABattleMobaCharacter> Characters;
+
+	TMobaTeamList<ABattleMobaPlayerState> PlayerStates;
+
+	TMobaTeamList<ABattleMobaCTF> Flags;
+
+	TMobaTeamList<ADestructibleTower> Towers;
+
+	TMobaTeamList<ABMobaTriggerCapsule> SafeZones;
+};
+
+template<> inline TMobaTeamList<ABattleMobaCharacter>& UMobaWorldRegistry::GetList<ABattleMobaCharacter>() { return Characters; }
+template<> inline TMobaTeamList<ABattleMobaPlayerState>& UMobaWorldRegistry::GetList<ABattleMobaPlayerState>() { return PlayerStates; }
+template<> inline TMobaTeamList<ABattleMobaCTF>& UMobaWorldRegistry::GetList<ABattleMobaCTF>() { return Flags; }
+template<> inline TMobaTeamList<ADestructibleTower>& UMobaWorldRegistry::GetList<ADestructibleTower>() { return Towers; }
+template<> inline TMobaTeamList<ABMobaTriggerCapsule>& UMobaWorldRegistry::GetList<ABMobaTriggerCapsule>() { return SafeZones; }